@@ -1,4 +1,15 @@
 #include "Algoritmo.h"
+#include "CompactGraph.h"
+#include "CommunityState.h"
+#include "Partition.h"
+#include "NeighborAccumulator.h"
+#include "WorkScheduler.h"
+#include "AsyncNodeQueue.h"
+#include "QualityFunction.h"
+#include "GainKernel.h"
+#include "Telemetry.h"
+#include "Dendrogram.h"
+#include "Checkpoint.h"
 #include <vector>
 #include <map>
 #include <algorithm> 
@@ -6,49 +17,127 @@
 #include <numeric>   
 #include <iostream>  
 #include <unordered_map>
-#include <unordered_set>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <cmath>
 #include <omp.h>
 namespace networkStructure {
 
+namespace {
+/**
+ * @brief Suma atómica sobre un double (fetch_add de std::atomic<double> requiere C++20).
+ */
+inline void atomicAdd(std::atomic<double>& target, double value) {
+    double current = target.load(std::memory_order_relaxed);
+    while (!target.compare_exchange_weak(current, current + value, std::memory_order_relaxed)) {
+    }
+}
+
+/**
+ * @brief Nº total de nodos originales de un grafo (suma de los tamaños de sus nodos).
+ */
+double totalSize(const CompactGraph& graph) {
+    double total = 0.0;
+    for (int i = 0; i < graph.getNNodes(); ++i) {
+        total += graph.getNodeSize(i);
+    }
+    return total;
+}
+
+/**
+ * @brief Nº de comunidades distintas de un vector de etiquetas con valores en [0, n).
+ */
+std::size_t countCommunities(const std::vector<int>& community) {
+    std::vector<char> seen(community.size(), 0);
+    std::size_t n_communities = 0;
+    for (int c : community) {
+        if (!seen[c]) {
+            seen[c] = 1;
+            ++n_communities;
+        }
+    }
+    return n_communities;
+}
+
+/**
+ * @brief Mejor comunidad vecina de un nodo (distinta de la actual) con una sola reducción vectorial.
+ * @param weights Pesos del nodo hacia cada comunidad vecina.
+ * @param state Tamaño y grado total de cada comunidad.
+ * @param current_comm Comunidad actual del nodo.
+ * @param gain Coeficientes de la ganancia del nodo (Quality::linearGain()).
+ * @param dQ Salida: ganancia de mover el nodo a la comunidad devuelta.
+ * @return ID de la mejor comunidad, o -1 si el nodo no tiene comunidades vecinas distintas de la suya.
+ */
+int bestMove(const NeighborAccumulator& weights, const CommunityState& state, int current_comm, const LinearGain& gain,
+             double& dQ) {
+    const std::vector<int>& keys = weights.getKeys();
+    double score = 0.0;
+    int best = bestNeighbor(keys.data(), keys.size(), current_comm, weights.getWeights(), state.getSizes(),
+                            state.getTotalDegrees(), gain.alpha, gain.beta, score);
+    dQ = score + gain.offset;
+    return best;
+}
+} // namespace
+
 Algoritmo::Algoritmo(networkStructure::Network* net)
-    : network(net) {
+    : network(net), owned_partition(new Partition()), partition(owned_partition.get()) {
+    if (network) partition->reset(*network);
+}
+
+Algoritmo::Algoritmo(networkStructure::Network* net, Partition* part)
+    : network(net), partition(part) {
+    if (network && !partition->matches(*network)) partition->reset(*network);
 }
 
 void Algoritmo::initializeCommunities() {
     if (!network) return; // Seguridad por si network es un puntero nulo
-    for (auto& pair : network->getNodesMap()) {
-        networkStructure::Node* node = pair.second.get();
-        node->setCommunity(node->getID());// Cada nodo en su propia comunidad
-    }
+    partition->reset(*network); // Cada nodo en su propia comunidad
 }
 
-std::map<int, double> Algoritmo::getNeighborCommunityWeights(networkStructure::Node* node) {
-    std::map<int, double> weights;
-    
+void Algoritmo::getNeighborCommunityWeights(networkStructure::Node* node, NeighborAccumulator& weights) {
+    weights.clear();
     for (networkStructure::Edge* edge : node->getAdjList()) {// Recorremos aristas incidentes
         networkStructure::Node* neighbor = edge->getOpposite(node);// Nodo vecino
-        int neighbor_comm = neighbor->getCommunity();// Comunidad del vecino
-        weights[neighbor_comm] += edge->getWeight();// Suma de pesos a la comunidad del vecino
+        int neighbor_comm = partition->getCommunity(neighbor->getID());// Comunidad del vecino
+        weights.add(neighbor_comm, edge->getWeight());// Suma de pesos a la comunidad del vecino
+    }
+}
+
+void Algoritmo::run(double min_gain, double gamma, MoveMode mode, bool reset_communities, QualityType quality) {
+    switch (quality) {
+    case QualityType::MODULARITY: runKernel<ModularityQuality>(min_gain, gamma, mode, reset_communities); break;
+    case QualityType::RBER:       runKernel<RBERQuality>(min_gain, gamma, mode, reset_communities); break;
+    default:                      runKernel<CPMQuality>(min_gain, gamma, mode, reset_communities); break;
     }
-    return weights;
 }
 
-void Algoritmo::run(double min_gain, double gamma) {
+template <class Quality>
+void Algoritmo::runKernel(double min_gain, double gamma, MoveMode mode, bool reset_communities) {
     if (!network || network->getNNodes() == 0) {
         return;
     }
-    initializeCommunities();
+    // Preparación: partición, grados, tamaños y agregados por comunidad
+    ScopedTimer setup_timer(telemetry, Phase::REBUILD);
+    if (reset_communities || !partition->matches(*network)) {
+        initializeCommunities();
+    } else {
+        partition->rebuild(*network); // la red o las etiquetas pueden haber cambiado desde la última vez
+    }
 
     // Vector de nodos a procesar desde 0 hasta N-1
     std::vector<Node*> nodes_to_process;
     nodes_to_process.reserve(network->getNNodes());
-    for (const auto& pair : network->getNodesMap()) {
-        nodes_to_process.push_back(pair.second.get());
+    for (const auto& ptr : network->getNodes()) {
+        if (ptr) nodes_to_process.push_back(ptr.get());
     }
     if (nodes_to_process.empty()) return;
 
-    // Cálculo de grados (k_i) y 2m = suma total de grados
+    // Cálculo de grados (k_i), bucles y 2m = suma total de grados
     std::vector<double> node_degrees(nodes_to_process.size(), 0.0);
+    std::vector<double> node_self_loops(nodes_to_process.size(), 0.0);
+    std::vector<unsigned int> node_sizes(nodes_to_process.size(), 1); // nº de nodos originales
+    std::vector<std::size_t> node_costs(nodes_to_process.size(), 1);  // coste estimado de evaluar cada nodo
     double total_degree = 0.0;
 
     for (std::size_t i = 0; i < nodes_to_process.size(); ++i) {
@@ -60,243 +149,1426 @@ void Algoritmo::run(double min_gain, double gamma) {
         for (Edge* e : edges_of_node) {
             if (!e) continue;
             k_i += e->getWeight();
+            if (e->getOpposite(node) == node) {
+                k_i += e->getWeight(); // los bucles cuentan dos veces en el grado
+                node_self_loops[i] += e->getWeight();
+            }
         }
         node_degrees[i] = k_i;
+        node_costs[i] = edges_of_node.size() + 1;
         total_degree += k_i;
+        node_sizes[i] = node->getSize();
     }
 
     if (total_degree == 0.0) {
         return;
     }
-    // Algoritmo de planificación de carga para dividir nodos entre procesadores
-    int P = omp_get_max_threads();
-    if (P < 1) P = 1;
-
-    std::vector<int> inicial(P, 0);
-    std::vector<int> final_idx(P, 0);
+    double total_size = 0.0;
+    for (unsigned int n_i : node_sizes) {
+        total_size += n_i;
+    }
+    const Quality quality(gamma, total_degree, total_size);
 
-    double load = total_degree / static_cast<double>(P);
-    int l = 0;
-    double suma = 0.0;
-    inicial[0] = 0;
-    
+    // Agregados por comunidad de la partición, indexados por ID. Se actualizan en O(1) con cada
+    // movimiento (Partition::moveNode()) en lugar de reconstruirse en cada iteración.
+    const CommunityState& community_state = partition->getState();
+    // Conjunto de nodos activos: solo se evalúan los nodos cuyo vecindario ha cambiado. Tras cada
+    // movimiento se marcan sus vecinos en un mapa de bits y se añaden (sin repetir) a la lista del
+    // siguiente barrido. El primer barrido evalúa todos los nodos.
     int N = static_cast<int>(nodes_to_process.size());
-	
-    for (int i = 0; i < N && l < P-1; ++i) {
-        if (suma < load) {
-            suma += node_degrees[i];
-        } else {
-            final_idx[l] = i;
-            ++l;
-            inicial[l] = i+1;
-            suma = 0.0;
-        }
+    std::vector<int> index_of_id(network->getIdBound(), -1); // ID de nodo -> índice en nodes_to_process
+    for (int i = 0; i < N; ++i) {
+        index_of_id[nodes_to_process[i]->getID()] = i;
     }
-    final_idx[l] = N-1;
+    std::vector<int> active(N);
+    std::iota(active.begin(), active.end(), 0);
+    std::vector<int> next_active;
+    std::vector<char> in_next(N, 0);
+    auto markActive = [&](int idx) {
+        if (!in_next[idx]) {
+            in_next[idx] = 1;
+            next_active.push_back(idx);
+        }
+    };
+    auto markNeighbors = [&](Node* node) {
+        for (Edge* e : node->getAdjList()) {
+            Node* neighbor = e->getOpposite(node);
+            if (neighbor && neighbor != node) markActive(index_of_id[neighbor->getID()]);
+        }
+    };
+    std::vector<std::size_t> active_costs;
+
+    // Planificación de carga: bloques de coste parecido con robo de trabajo entre hilos
+    int P = omp_get_max_threads();
+    if (P < 1) P = 1;
+    WorkScheduler scheduler(node_costs, P);
 
     // Estructura para guardar el mejor cambio
     struct Change {
+        int iaux;   // índice del nodo en nodes_to_process
         int jaux;   // ID del nodo a mover
         int kaux;   // comunidad destino
         double dQ;  // ganancia de calidad
     };
     std::vector<Change> changeData(P);
 
+    // Mejor movimiento de cada nodo evaluado: en modo BATCH son los movimientos a aplicar y en ambos
+    // modos sirven para mantener activos los nodos que aún tienen una mejora pendiente.
+    struct Proposal {
+        int idx;    // índice del nodo en nodes_to_process
+        int dest;   // comunidad destino
+        double dQ;  // ganancia estimada con el estado del inicio del barrido
+    };
+    std::vector<std::vector<Proposal>> proposals(P);
+
+    // Acumuladores de pesos por comunidad vecina: uno por hilo y otro para la fase secuencial.
+    // Se reservan una vez y se vacían en O(d) tras cada nodo.
+    std::vector<NeighborAccumulator> thread_weights(P);
+    NeighborAccumulator commit_weights(community_state.getCapacity());
+
     bool improved;
-    double totalIteraciones = 0.0;
+    unsigned long iteraciones = 0;
+    unsigned long movimientos = 0;
+    unsigned long evaluaciones = 0;
+    unsigned long rechazados = 0;
+
+    // Métricas: la calidad de cada barrido es la inicial más los ΔQ aplicados
+    unsigned int run_id = 0;
+    double current_quality = 0.0;
+    if (TELEMETRY_ENABLED && telemetry) {
+        run_id = telemetry->beginRun();
+        for (std::size_t c = 0; c < community_state.getCapacity(); ++c) {
+            int comm = static_cast<int>(c);
+            if (community_state.getSize(comm) == 0) continue;
+            current_quality += community_state.getInternalWeight(comm) -
+                               quality.penalty(community_state.getSize(comm), community_state.getTotalDegree(comm));
+        }
+    }
+    setup_timer.stop();
 
     // Bucle principal
     double t0 = omp_get_wtime();
     do {
         improved = false;
+        ++iteraciones;
+        evaluaciones += active.size();
+        double sweep_start = Telemetry::now();
+        std::size_t sweep_active = active.size();
+        unsigned long moves_before = movimientos;
+        double applied_gain = 0.0;
 
-        // Tamaños de comunidad (community_sizes[comm] = nº nodos)
-        std::map<int, unsigned int> community_sizes;
-        for (const auto& pair : network->getNodesMap()) {
-            Node* node = pair.second.get();
-            if (!node) continue;
-            int comm = node->getCommunity();
-            community_sizes[comm] += 1;
+        // Bloques del barrido sobre la lista de nodos activos
+        active_costs.resize(active.size());
+        for (std::size_t k = 0; k < active.size(); ++k) {
+            active_costs[k] = node_costs[active[k]];
         }
-        if (community_sizes.empty()) break;
+        scheduler.assign(active_costs);
 
         // Inicializamos los datos de cambio de cada hilo
         for (int i = 0; i < P; ++i) {
+            changeData[i].iaux = -1;
             changeData[i].jaux = -1;
             changeData[i].kaux = -1;
             changeData[i].dQ   = 0.0;
+            proposals[i].clear();
         }
-        
-        //double t0 = omp_get_wtime();  Si se quiere medir tiempo de iteraciones
-        // Sección paralela: cada hilo busca su mejor movimiento local
-        #pragma omp parallel
+
+        // Sección paralela: cada hilo busca su mejor movimiento local (SPLICE)
+        // o el mejor movimiento de cada uno de sus nodos (BATCH)
+        ScopedTimer parallel_timer(telemetry, Phase::PARALLEL);
+        scheduler.beginSweep();
+        #pragma omp parallel num_threads(P)
         {
             int tid = omp_get_thread_num();
 
-            int from = (tid < P ? inicial[tid]   : 0);
-            int to   = (tid < P ? final_idx[tid] : 0);
+            NeighborAccumulator& neighbor_comm_weights = thread_weights[tid];
+            if (neighbor_comm_weights.getCapacity() != community_state.getCapacity()) {
+                neighbor_comm_weights.resize(community_state.getCapacity());
+            }
             
+            int   best_node_idx  = -1;
             int   best_node_id   = -1;
             int   best_comm_dest = -1;
             double best_dQ       = 0.0;
+            std::uint64_t dq_evaluations = 0; // comunidades candidatas evaluadas por este hilo
 
-            for (int idx = from; idx < to; ++idx) {
-                Node* currentNode = nodes_to_process[idx];
-                if (!currentNode) continue;
+            WorkChunk chunk;
+            while (scheduler.next(tid, chunk)) {
+                for (int k = chunk.begin; k < chunk.end; ++k) {
+                    int idx = active[k];
+                    Node* currentNode = nodes_to_process[idx];
+                    if (!currentNode) continue;
 
-                int current_comm = currentNode->getCommunity();
+                    int current_comm = partition->getCommunity(currentNode->getID());
 
-                // tamaño de la comunidad actual
-                unsigned int size_i = 0;
-                auto it_size_i = community_sizes.find(current_comm);
-                if (it_size_i != community_sizes.end()) {
-                    size_i = it_size_i->second;
-                }
-
-                // pesos hacia cada comunidad vecina
-                std::map<int, double> neighbor_comm_weights = getNeighborCommunityWeights(currentNode);
-
-                // k_i_in_i: peso de aristas de i dentro de su propia comunidad actual
-                double k_i_in_i = 0.0;
-                auto it_self = neighbor_comm_weights.find(current_comm);
-                if (it_self != neighbor_comm_weights.end()) {
-                    k_i_in_i = it_self->second;
-                }
+                    // tamaño de la comunidad actual
+                    unsigned int size_i = community_state.getSize(current_comm);
 
-                // Recorremos comunidades vecinas para ver a cual moverla
-                for (const auto& entry : neighbor_comm_weights) {
-                    int comm_j = entry.first;
-                    double k_i_in_j = entry.second;
+                    // pesos hacia cada comunidad vecina
+                    getNeighborCommunityWeights(currentNode, neighbor_comm_weights);
+                    dq_evaluations += neighbor_comm_weights.getKeys().size() -
+                                      (neighbor_comm_weights.contains(current_comm) ? 1 : 0);
 
-                    if (comm_j == current_comm) continue;
+                    // k_i_in_i: peso de aristas de i dentro de su propia comunidad actual
+                    // (los bucles se mueven con el nodo, así que no cuentan)
+                    double k_i_in_i = neighbor_comm_weights.get(current_comm) - node_self_loops[idx];
+                    double n_i = static_cast<double>(node_sizes[idx]);
 
-                    unsigned int size_j = 0;
-                    auto it_size_j = community_sizes.find(comm_j);
-                    if (it_size_j != community_sizes.end()) {
-                        size_j = it_size_j->second;
-                    }
-                    // ΔQ según CPM para mover 'currentNode' de 'current_comm' a 'comm_j'
-                    double dQ = (k_i_in_j - k_i_in_i) + gamma * (static_cast<double>(size_i) - static_cast<double>(size_j) - 1.0);
-                    // Criterio SPLICE: nos quedamos con el mejor ΔQ del hilo
-                    if (dQ - best_dQ > min_gain) {
-                        best_dQ       = dQ;
+                    // ΔQ de mover 'currentNode' de 'current_comm' a cada comunidad vecina y la mejor de ellas
+                    LinearGain gain = quality.linearGain(k_i_in_i, n_i, node_degrees[idx], static_cast<double>(size_i),
+                                                         community_state.getTotalDegree(current_comm));
+                    double node_best_dQ = 0.0;
+                    int node_best_comm = bestMove(neighbor_comm_weights, community_state, current_comm, gain, node_best_dQ);
+                    // Criterio BATCH: el mejor ΔQ de cada nodo, si supera el umbral
+                    if (node_best_comm != -1 && node_best_dQ <= min_gain) node_best_comm = -1;
+                    if (mode == MoveMode::SPLICE && node_best_comm != -1 && node_best_dQ - best_dQ > min_gain) {
+                        // Criterio SPLICE: nos quedamos con el mejor ΔQ del hilo
+                        best_dQ       = node_best_dQ;
+                        best_node_idx = idx;
                         best_node_id  = static_cast<int>(currentNode->getID());
-                        best_comm_dest = comm_j;
+                        best_comm_dest = node_best_comm;
+                    }
+                    if (node_best_comm != -1) {
+                        proposals[tid].push_back({idx, node_best_comm, node_best_dQ});
                     }
                 }
             }
             // Guardamos el mejor cambio encontrado
-            if (tid < P) {
-                changeData[tid].jaux = best_node_id;
-                changeData[tid].kaux = best_comm_dest;
-                changeData[tid].dQ   = best_dQ;
+            changeData[tid].iaux = best_node_idx;
+            changeData[tid].jaux = best_node_id;
+            changeData[tid].kaux = best_comm_dest;
+            changeData[tid].dQ   = best_dQ;
+            if (TELEMETRY_ENABLED && telemetry) {
+                telemetry->add(Counter::DQ_EVALUATIONS, dq_evaluations);
+                telemetry->add(Counter::MOVES_PROPOSED, proposals[tid].size());
             }
         } // fin región paralela
-        //double t1 = omp_get_wtime(); Si se quiere medir tiempo de iteraciones
-        //totalIteraciones += (t1 - t0);
+        scheduler.endSweep();
+        parallel_timer.stop();
 
-        // Elegimos el mejor movimiento global entre todos los hilos
-        int pmax = -1;
-        double dQmax = 0.0;
-        for (int i = 0; i < P; ++i) {
-            if (changeData[i].dQ > dQmax) {
-                dQmax = changeData[i].dQ;
-                pmax = i;
+        ScopedTimer apply_timer(telemetry, Phase::APPLY);
+        if (mode == MoveMode::BATCH) {
+            // Reunimos las propuestas de todos los hilos y aplicamos primero las de mayor ΔQ
+            std::vector<Proposal> batch;
+            for (int i = 0; i < P; ++i) {
+                batch.insert(batch.end(), proposals[i].begin(), proposals[i].end());
             }
-        }
-        // Aplicamos localMove si hay mejora positiva
-        if (pmax != -1 && dQmax > 0.0 && changeData[pmax].jaux != -1 && changeData[pmax].kaux != -1) {
-            Node* node_to_move = network->getNode(static_cast<unsigned int>(changeData[pmax].jaux));
-            if (node_to_move) {
-                node_to_move->setCommunity(changeData[pmax].kaux);
+            // (a igual ΔQ, por índice: el orden no depende de qué hilo procesó cada bloque)
+            std::sort(batch.begin(), batch.end(), [](const Proposal& a, const Proposal& b) {
+                return a.dQ > b.dQ || (a.dQ == b.dQ && a.idx < b.idx);
+            });
+
+            // Validación diferida: varios movimientos pueden tocar las mismas comunidades o
+            // nodos vecinos, así que recalculamos ΔQ con el estado actual antes de aplicar cada uno.
+            for (const Proposal& prop : batch) {
+                Node* node = nodes_to_process[prop.idx];
+                int current_comm = partition->getCommunity(node->getID());
+                if (current_comm == prop.dest) continue;
+
+                getNeighborCommunityWeights(node, commit_weights);
+                if (!commit_weights.contains(prop.dest)) { // el destino ya no es vecino
+                    markActive(prop.idx);
+                    ++rechazados;
+                    continue;
+                }
+                double k_i_in_i = commit_weights.get(current_comm) - node_self_loops[prop.idx];
+                double k_i_in_j = commit_weights.get(prop.dest);
+
+                double size_i = static_cast<double>(community_state.getSize(current_comm));
+                double size_j = static_cast<double>(community_state.getSize(prop.dest));
+                double dQ = quality.gain(k_i_in_j, k_i_in_i, static_cast<double>(node_sizes[prop.idx]), node_degrees[prop.idx],
+                                         size_i, community_state.getTotalDegree(current_comm), size_j,
+                                         community_state.getTotalDegree(prop.dest));
+                if (dQ <= min_gain) {
+                    markActive(prop.idx); // se vuelve a evaluar en el siguiente barrido
+                    ++rechazados;
+                    continue;
+                }
+
+                partition->moveNode(node->getID(), prop.dest, node_sizes[prop.idx], node_degrees[prop.idx],
+                                    k_i_in_i, k_i_in_j, node_self_loops[prop.idx]);
+                markNeighbors(node);
+                ++movimientos;
+                applied_gain += dQ;
                 improved = true;
             }
         } else {
+            // SPLICE: elegimos el mejor movimiento global entre todos los hilos
+            int pmax = -1;
+            double dQmax = 0.0;
+            for (int i = 0; i < P; ++i) {
+                if (changeData[i].dQ > dQmax) {
+                    dQmax = changeData[i].dQ;
+                    pmax = i;
+                }
+            }
+            // Aplicamos localMove si hay mejora positiva
+            if (pmax != -1 && dQmax > 0.0 && changeData[pmax].jaux != -1 && changeData[pmax].kaux != -1) {
+                int idx_move = changeData[pmax].iaux;
+                Node* node_to_move = nodes_to_process[idx_move];
+                if (node_to_move) {
+                    int from = partition->getCommunity(node_to_move->getID());
+                    int to = changeData[pmax].kaux;
+                    getNeighborCommunityWeights(node_to_move, commit_weights);
+                    partition->moveNode(node_to_move->getID(), to, node_sizes[idx_move], node_degrees[idx_move],
+                                        commit_weights.get(from) - node_self_loops[idx_move], commit_weights.get(to),
+                                        node_self_loops[idx_move]);
+                    markNeighbors(node_to_move);
+                    ++movimientos;
+                    applied_gain += dQmax;
+                    improved = true;
+                }
+                // Los demás nodos con una mejora pendiente siguen activos
+                for (int i = 0; i < P; ++i) {
+                    for (const Proposal& prop : proposals[i]) {
+                        if (prop.idx != idx_move) markActive(prop.idx);
+                    }
+                }
+            } else {
+                improved = false;
+            }
+        }
+        apply_timer.stop();
+        if (TELEMETRY_ENABLED && telemetry) {
+            current_quality += applied_gain;
+            Telemetry::SweepRecord record;
+            record.run = run_id;
+            record.sweep = static_cast<unsigned int>(iteraciones);
+            record.active = sweep_active;
+            record.moves = movimientos - moves_before;
+            record.quality = current_quality;
+            record.seconds = Telemetry::now() - sweep_start;
+            telemetry->recordSweep(record);
+        }
+
+        // Los nodos marcados forman la lista del siguiente barrido
+        active.swap(next_active);
+        next_active.clear();
+        for (int idx : active) {
+            in_next[idx] = 0;
+        }
+        if (active.empty()) {
             improved = false;
         }
     } while (improved);
     double t1 = omp_get_wtime();
-    std::cout << "Tiempo de ejecucion de las iteraciones: " << (t1 - t0) << " segundos." << std::endl;
+    if (verbose) {
+        std::cout << "Tiempo de ejecucion de las iteraciones: " << (t1 - t0) << " segundos." << std::endl;
+        std::cout << "Iteraciones: " << iteraciones << " | Movimientos aplicados: " << movimientos
+                  << " | Nodos evaluados: " << evaluaciones << std::endl;
+    }
+
+    // Reparto de la carga entre hilos
+    thread_stats = scheduler.getStats();
+    if (TELEMETRY_ENABLED && telemetry) {
+        telemetry->add(Counter::SWEEPS, iteraciones);
+        telemetry->add(Counter::NODES_EVALUATED, evaluaciones);
+        telemetry->add(Counter::MOVES_APPLIED, movimientos);
+        telemetry->add(Counter::MOVES_REJECTED, rechazados);
+        telemetry->recordThreadStats(thread_stats);
+    }
+    if (verbose) {
+        std::cout << "Planificador: " << scheduler.getNChunks() << " bloques en " << P << " hilos" << std::endl;
+        for (int t = 0; t < P; ++t) {
+            const WorkScheduler::ThreadStats& st = thread_stats[t];
+            std::cout << "  Hilo " << t << ": ocupado " << st.busy_time << " s | inactivo " << st.idle_time
+                      << " s | " << st.chunks << " bloques (" << st.stolen << " robados)" << std::endl;
+        }
+    }
+}
+
+void Algoritmo::runCompact(double min_gain, double gamma, QualityType quality) {
+    if (!network || network->getNNodes() == 0) {
+        return;
+    }
+    // Instantánea CSR: a partir de aquí solo se usan índices densos
+    CompactGraph graph(*network);
+    std::vector<int> community = runCompact(graph, min_gain, gamma, verbose, quality);
+
+    // Volcamos las etiquetas densas sobre la partición
+    if (!partition->matches(*network)) partition->reset(*network);
+    for (int i = 0; i < graph.getNNodes(); ++i) {
+        partition->setCommunity(static_cast<unsigned int>(graph.getOriginalID(i)),
+                                static_cast<int>(graph.getOriginalID(community[i])));
+    }
+    partition->rebuild(*network);
+}
+
+std::vector<int> Algoritmo::runCompact(const CompactGraph& graph, double min_gain, double gamma, bool verbose,
+                                       QualityType quality) {
+    switch (quality) {
+    case QualityType::MODULARITY: return compactKernel<ModularityQuality>(graph, min_gain, gamma, verbose);
+    case QualityType::RBER:       return compactKernel<RBERQuality>(graph, min_gain, gamma, verbose);
+    default:                      return compactKernel<CPMQuality>(graph, min_gain, gamma, verbose);
+    }
+}
+
+template <class Quality>
+std::vector<int> Algoritmo::compactKernel(const CompactGraph& graph, double min_gain, double gamma, bool verbose) {
+    int N = graph.getNNodes();
+
+    // Cada nodo empieza en su propia comunidad (identificada por su índice denso)
+    std::vector<int> community(N);
+    std::iota(community.begin(), community.end(), 0);
+    if (N == 0 || graph.getTotalWeight() == 0.0) {
+        return community;
+    }
+    CommunityState community_state(N);
+    for (int i = 0; i < N; ++i) {
+        community_state.addNode(i, graph.getNodeSize(i), graph.getDegree(i), 0.0, graph.getSelfLoop(i));
+    }
+    const Quality quality(gamma, graph.getTotalWeight(), totalSize(graph));
+
+    int P = omp_get_max_threads();
+    if (P < 1) P = 1;
+
+    struct Proposal {
+        int node;   // índice denso del nodo a mover
+        int dest;   // comunidad destino
+        double dQ;  // ganancia estimada con el estado del inicio del barrido
+    };
+    std::vector<std::vector<Proposal>> proposals(P);
+
+    // Pesos por comunidad vecina de cada hilo. Se reservan una vez y se reutilizan en todos los barridos.
+    std::vector<NeighborAccumulator> thread_weights(P);
+
+    // Nodos activos (ver run()): tras el primer barrido solo se evalúan los vecinos de nodos movidos
+    std::vector<int> active(N);
+    std::iota(active.begin(), active.end(), 0);
+    std::vector<int> next_active;
+    std::vector<char> in_next(N, 0);
+    auto markActive = [&](int i) {
+        if (!in_next[i]) {
+            in_next[i] = 1;
+            next_active.push_back(i);
+        }
+    };
+
+    bool improved;
+    unsigned long iteraciones = 0;
+    unsigned long movimientos = 0;
+    unsigned long evaluaciones = 0;
+
+    double t0 = omp_get_wtime();
+    do {
+        improved = false;
+        ++iteraciones;
+        evaluaciones += active.size();
+        int n_active = static_cast<int>(active.size());
+
+        // Sección paralela: cada hilo propone el mejor movimiento de cada uno de sus nodos
+        #pragma omp parallel
+        {
+            int tid = omp_get_thread_num();
+            proposals[tid].clear();
+
+            NeighborAccumulator& comm_weight = thread_weights[tid];
+            if (comm_weight.getCapacity() != static_cast<std::size_t>(N)) {
+                comm_weight.resize(N);
+            }
+
+            #pragma omp for schedule(dynamic, 256)
+            for (int k = 0; k < n_active; ++k) {
+                int i = active[k];
+                int current_comm = community[i];
+
+                for (std::size_t e = graph.begin(i); e < graph.end(i); ++e) {
+                    comm_weight.add(community[graph.neighbor(e)], graph.weight(e));
+                }
+
+                double k_i_in_i = comm_weight.get(current_comm);
+                double size_i = static_cast<double>(community_state.getSize(current_comm));
+                double n_i = static_cast<double>(graph.getNodeSize(i));
+
+                // ΔQ para mover i de 'current_comm' a cada comunidad vecina y la mejor de ellas
+                LinearGain gain = quality.linearGain(k_i_in_i, n_i, graph.getDegree(i), size_i,
+                                                     community_state.getTotalDegree(current_comm));
+                double best_dQ = 0.0;
+                int best_comm = bestMove(comm_weight, community_state, current_comm, gain, best_dQ);
+                comm_weight.clear();
+
+                if (best_comm != -1 && best_dQ > min_gain) {
+                    proposals[tid].push_back({i, best_comm, best_dQ});
+                }
+            }
+        } // fin región paralela
+
+        std::vector<Proposal> batch;
+        for (int t = 0; t < P; ++t) {
+            batch.insert(batch.end(), proposals[t].begin(), proposals[t].end());
+        }
+        std::sort(batch.begin(), batch.end(), [](const Proposal& a, const Proposal& b) {
+            return a.dQ > b.dQ || (a.dQ == b.dQ && a.node < b.node);
+        });
+
+        // Validación diferida de cada movimiento con las etiquetas y tamaños actualizados
+        for (const Proposal& prop : batch) {
+            int i = prop.node;
+            int current_comm = community[i];
+            if (current_comm == prop.dest) continue;
+
+            double k_i_in_i = 0.0;
+            double k_i_in_j = 0.0;
+            bool is_neighbor = false;
+            for (std::size_t e = graph.begin(i); e < graph.end(i); ++e) {
+                int comm = community[graph.neighbor(e)];
+                if (comm == current_comm) {
+                    k_i_in_i += graph.weight(e);
+                } else if (comm == prop.dest) {
+                    k_i_in_j += graph.weight(e);
+                    is_neighbor = true;
+                }
+            }
+            if (!is_neighbor) { // el destino ya no es vecino
+                markActive(i);
+                continue;
+            }
+
+            double size_i = static_cast<double>(community_state.getSize(current_comm));
+            double size_j = static_cast<double>(community_state.getSize(prop.dest));
+            double dQ = quality.gain(k_i_in_j, k_i_in_i, static_cast<double>(graph.getNodeSize(i)), graph.getDegree(i),
+                                     size_i, community_state.getTotalDegree(current_comm), size_j,
+                                     community_state.getTotalDegree(prop.dest));
+            if (dQ <= min_gain) {
+                markActive(i);
+                continue;
+            }
+
+            community[i] = prop.dest;
+            community_state.moveNode(current_comm, prop.dest, graph.getNodeSize(i), graph.getDegree(i),
+                                     k_i_in_i, k_i_in_j, graph.getSelfLoop(i));
+            for (std::size_t e = graph.begin(i); e < graph.end(i); ++e) {
+                markActive(graph.neighbor(e));
+            }
+            ++movimientos;
+            improved = true;
+        }
+
+        active.swap(next_active);
+        next_active.clear();
+        for (int i : active) {
+            in_next[i] = 0;
+        }
+        if (active.empty()) {
+            improved = false;
+        }
+    } while (improved);
+    double t1 = omp_get_wtime();
+
+    if (verbose) {
+        std::cout << "Tiempo de ejecucion de las iteraciones (CSR): " << (t1 - t0) << " segundos." << std::endl;
+        std::cout << "Iteraciones: " << iteraciones << " | Movimientos aplicados: " << movimientos
+                  << " | Nodos evaluados: " << evaluaciones << std::endl;
+    }
+    return community;
+}
+
+double Algoritmo::cpmQuality(const CompactGraph& graph, const std::vector<int>& community, double gamma) {
+    return evaluateQuality(graph, community, gamma, QualityType::CPM);
+}
+
+double Algoritmo::evaluateQuality(const CompactGraph& graph, const std::vector<int>& community, double gamma,
+                                  QualityType quality) {
+    switch (quality) {
+    case QualityType::MODULARITY: return qualityKernel<ModularityQuality>(graph, community, gamma);
+    case QualityType::RBER:       return qualityKernel<RBERQuality>(graph, community, gamma);
+    default:                      return qualityKernel<CPMQuality>(graph, community, gamma);
+    }
+}
+
+template <class Quality>
+double Algoritmo::qualityKernel(const CompactGraph& graph, const std::vector<int>& community, double gamma) {
+    int N = graph.getNNodes();
+    // Peso interno (cada arista una vez, bucles incluidos), tamaño y grado total de cada comunidad
+    std::vector<double> internal(N, 0.0);
+    std::vector<double> sizes(N, 0.0);
+    std::vector<double> degrees(N, 0.0);
+    for (int i = 0; i < N; ++i) {
+        int c = community[i];
+        sizes[c] += graph.getNodeSize(i);
+        degrees[c] += graph.getDegree(i);
+        internal[c] += graph.getSelfLoop(i);
+        for (std::size_t e = graph.begin(i); e < graph.end(i); ++e) {
+            if (community[graph.neighbor(e)] == c) internal[c] += 0.5 * graph.weight(e);
+        }
+    }
+    const Quality policy(gamma, graph.getTotalWeight(), totalSize(graph));
+    double quality = 0.0;
+    for (int c = 0; c < N; ++c) {
+        if (sizes[c] > 0.0) quality += internal[c] - policy.penalty(sizes[c], degrees[c]);
+    }
+    return quality;
+}
+
+std::vector<ResolutionResult> Algoritmo::sweepResolution(const CompactGraph& graph, const std::vector<double>& gammas,
+                                                         double min_gain, int bisect_depth, QualityType quality) {
+    std::vector<ResolutionResult> results;
+    int P = omp_get_max_threads();
+    if (P < 1) P = 1;
+    int saved_levels = omp_get_max_active_levels();
+    omp_set_max_active_levels(2);
+
+    // Ejecuta en paralelo un lote de valores de gamma: cada uno con su propio vector de etiquetas y
+    // los hilos restantes repartidos entre ellos para el barrido interno; el grafo solo se lee.
+    auto runBatch = [&](const std::vector<double>& batch) {
+        int G = static_cast<int>(batch.size());
+        if (G == 0) return;
+        int outer = std::min(G, P);
+        int inner = std::max(1, P / outer);
+        std::vector<ResolutionResult> batch_results(G);
+        #pragma omp parallel for schedule(dynamic, 1) num_threads(outer)
+        for (int g = 0; g < G; ++g) {
+            omp_set_num_threads(inner);
+            double t0 = omp_get_wtime();
+            std::vector<int> community = runCompact(graph, min_gain, batch[g], false, quality);
+            double t1 = omp_get_wtime();
+            batch_results[g] = {batch[g], countCommunities(community), evaluateQuality(graph, community, batch[g], quality),
+                                t1 - t0};
+        }
+        results.insert(results.end(), batch_results.begin(), batch_results.end());
+    };
+
+    runBatch(gammas);
+    std::sort(results.begin(), results.end(), [](const ResolutionResult& a, const ResolutionResult& b) {
+        return a.gamma < b.gamma;
+    });
+
+    // Bisección: entre dos valores consecutivos con distinto nº de comunidades se prueba el punto medio
+    // (geométrico si ambos son positivos, porque gamma suele recorrer varios órdenes de magnitud). Así se
+    // localizan los límites de las mesetas de estabilidad sin barrer finamente todo el rango.
+    for (int depth = 0; depth < bisect_depth; ++depth) {
+        std::vector<double> midpoints;
+        for (std::size_t k = 1; k < results.size(); ++k) {
+            const ResolutionResult& lo = results[k - 1];
+            const ResolutionResult& hi = results[k];
+            if (lo.n_communities == hi.n_communities) continue;
+            double mid = (lo.gamma > 0.0 && hi.gamma > 0.0) ? std::sqrt(lo.gamma * hi.gamma) : 0.5 * (lo.gamma + hi.gamma);
+            if (mid > lo.gamma && mid < hi.gamma) midpoints.push_back(mid);
+        }
+        if (midpoints.empty()) break;
+        runBatch(midpoints);
+        std::sort(results.begin(), results.end(), [](const ResolutionResult& a, const ResolutionResult& b) {
+            return a.gamma < b.gamma;
+        });
+    }
+
+    omp_set_max_active_levels(saved_levels);
+    return results;
+}
+
+template <class Quality>
+std::vector<int> Algoritmo::runRandomOrder(const CompactGraph& graph, double min_gain, double gamma, std::mt19937& rng,
+                                           const std::vector<int>* initial) {
+    int N = graph.getNNodes();
+    std::vector<int> community(N);
+    if (initial) {
+        community = *initial;
+    } else {
+        std::iota(community.begin(), community.end(), 0);
+    }
+    if (N == 0 || graph.getTotalWeight() == 0.0) {
+        return community;
+    }
+    CommunityState community_state(N);
+    for (int i = 0; i < N; ++i) {
+        // Cada arista interna se visita desde sus dos extremos: la mitad en cada uno
+        double k_in = 0.0;
+        for (std::size_t e = graph.begin(i); e < graph.end(i); ++e) {
+            if (community[graph.neighbor(e)] == community[i]) k_in += 0.5 * graph.weight(e);
+        }
+        community_state.addNode(community[i], graph.getNodeSize(i), graph.getDegree(i), k_in, graph.getSelfLoop(i));
+    }
+    const Quality quality(gamma, graph.getTotalWeight(), totalSize(graph));
+    NeighborAccumulator comm_weight(N);
+
+    // Cola circular de nodos pendientes, inicializada con una permutación aleatoria
+    std::vector<int> queue(N);
+    std::iota(queue.begin(), queue.end(), 0);
+    std::shuffle(queue.begin(), queue.end(), rng);
+    std::vector<char> queued(N, 1);
+    std::size_t head = 0;
+    std::size_t pending = static_cast<std::size_t>(N);
+
+    while (pending > 0) {
+        int i = queue[head];
+        head = (head + 1) % queue.size();
+        --pending;
+        queued[i] = 0;
+
+        int current_comm = community[i];
+        for (std::size_t e = graph.begin(i); e < graph.end(i); ++e) {
+            comm_weight.add(community[graph.neighbor(e)], graph.weight(e));
+        }
+        double k_i_in_i = comm_weight.get(current_comm);
+        double size_i = static_cast<double>(community_state.getSize(current_comm));
+        double n_i = static_cast<double>(graph.getNodeSize(i));
+        LinearGain gain = quality.linearGain(k_i_in_i, n_i, graph.getDegree(i), size_i,
+                                             community_state.getTotalDegree(current_comm));
+        double best_dQ = 0.0;
+        int best_comm = bestMove(comm_weight, community_state, current_comm, gain, best_dQ);
+        if (best_comm == -1 || best_dQ <= min_gain) {
+            comm_weight.clear();
+            continue;
+        }
+
+        community[i] = best_comm;
+        community_state.moveNode(current_comm, best_comm, graph.getNodeSize(i), graph.getDegree(i),
+                                 k_i_in_i, comm_weight.get(best_comm), graph.getSelfLoop(i));
+        comm_weight.clear();
+
+        // Solo los vecinos que no están en la nueva comunidad pueden cambiar su mejor movimiento
+        for (std::size_t e = graph.begin(i); e < graph.end(i); ++e) {
+            int j = graph.neighbor(e);
+            if (queued[j] || community[j] == best_comm) continue;
+            queued[j] = 1;
+            queue[(head + pending) % queue.size()] = j;
+            ++pending;
+        }
+    }
+    return community;
+}
+
+EnsembleResult Algoritmo::runEnsemble(const CompactGraph& graph, double gamma, int n_runs, double min_gain,
+                                      double threshold, double time_budget, unsigned int seed, QualityType quality) {
+    switch (quality) {
+    case QualityType::MODULARITY:
+        return ensembleKernel<ModularityQuality>(graph, gamma, n_runs, min_gain, threshold, time_budget, seed);
+    case QualityType::RBER:
+        return ensembleKernel<RBERQuality>(graph, gamma, n_runs, min_gain, threshold, time_budget, seed);
+    default:
+        return ensembleKernel<CPMQuality>(graph, gamma, n_runs, min_gain, threshold, time_budget, seed);
+    }
+}
+
+template <class Quality>
+EnsembleResult Algoritmo::ensembleKernel(const CompactGraph& graph, double gamma, int n_runs, double min_gain,
+                                         double threshold, double time_budget, unsigned int seed) {
+    EnsembleResult result;
+    int N = graph.getNNodes();
+    if (n_runs < 1) n_runs = 1;
+    int P = omp_get_max_threads();
+    if (P < 1) P = 1;
+
+    double t0 = omp_get_wtime();
+    auto budgetLeft = [&]() { return time_budget <= 0.0 || omp_get_wtime() - t0 < time_budget; };
+
+    // Lanza las ejecuciones aleatorias sobre 'g' (una por hilo a la vez; el grafo solo se lee) y deja las
+    // completadas al principio de 'runs', en orden de k. Devuelve cuántas se completaron.
+    std::vector<std::vector<int>> runs(n_runs);
+    std::vector<double> seconds(n_runs, 0.0);
+    auto runAll = [&](const CompactGraph& g, unsigned int round) {
+        std::vector<char> done(n_runs, 0);
+        #pragma omp parallel for schedule(dynamic, 1) num_threads(std::min(n_runs, P))
+        for (int k = 0; k < n_runs; ++k) {
+            if (!budgetLeft()) continue;
+            double start = omp_get_wtime();
+            std::seed_seq seq{seed, round, static_cast<unsigned int>(k)};
+            std::mt19937 rng(seq);
+            runs[k] = runRandomOrder<Quality>(g, min_gain, gamma, rng);
+            seconds[k] = omp_get_wtime() - start;
+            done[k] = 1;
+        }
+        int completed = 0;
+        for (int k = 0; k < n_runs; ++k) {
+            if (!done[k]) continue;
+            runs[completed].swap(runs[k]);
+            seconds[completed] = seconds[k];
+            ++completed;
+        }
+        return completed;
+    };
+
+    // Fase 1: ejecuciones sobre el grafo original, de las que salen las estadísticas de calidad
+    int K = runAll(graph, 0);
+    result.run_seconds.assign(seconds.begin(), seconds.begin() + K);
+    result.run_quality.resize(K);
+    result.run_communities.resize(K);
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int k = 0; k < K; ++k) {
+        result.run_quality[k] = qualityKernel<Quality>(graph, runs[k], gamma);
+        result.run_communities[k] = countCommunities(runs[k]);
+    }
+    if (K > 0) {
+        result.quality_min = *std::min_element(result.run_quality.begin(), result.run_quality.end());
+        result.quality_max = *std::max_element(result.run_quality.begin(), result.run_quality.end());
+        for (double q : result.run_quality) result.quality_mean += q;
+        result.quality_mean /= K;
+        for (double q : result.run_quality) {
+            result.quality_stddev += (q - result.quality_mean) * (q - result.quality_mean);
+        }
+        result.quality_stddev = std::sqrt(result.quality_stddev / K);
+    }
+
+    // Fase 2: consenso iterado. Cada ronda construye el grafo de consenso disperso sobre las aristas del
+    // grafo actual (sin pares que no sean vecinos) y vuelve a lanzar las ejecuciones sobre él, hasta que
+    // todas coinciden (cada fracción es 0 o 1) o se agotan las rondas o el presupuesto.
+    double t1 = omp_get_wtime();
+    if (K == 0) {
+        result.community.resize(N);
+        std::iota(result.community.begin(), result.community.end(), 0);
+    } else {
+        std::unique_ptr<CompactGraph> consensus;
+        for (unsigned int round = 1;; ++round) {
+            const CompactGraph& current = consensus ? *consensus : graph;
+            std::vector<double> arc_weights(current.getNArcs(), 0.0);
+            bool unanimous = true;
+            #pragma omp parallel for schedule(dynamic, 256) reduction(&& : unanimous)
+            for (int i = 0; i < N; ++i) {
+                for (std::size_t e = current.begin(i); e < current.end(i); ++e) {
+                    int j = current.neighbor(e);
+                    int together = 0;
+                    for (int k = 0; k < K; ++k) {
+                        together += (runs[k][i] == runs[k][j]);
+                    }
+                    unanimous = unanimous && (together == 0 || together == K);
+                    double fraction = static_cast<double>(together) / K;
+                    if (fraction >= threshold) arc_weights[e] = current.weight(e);
+                }
+            }
+            if (unanimous) {
+                result.community = runs[0];
+                break;
+            }
+            consensus.reset(new CompactGraph(current, arc_weights));
+            if (round > static_cast<unsigned int>(ENSEMBLE_MAX_ROUNDS) || !budgetLeft() ||
+                (K = runAll(*consensus, round)) == 0) {
+                std::seed_seq seq{seed, round};
+                std::mt19937 rng(seq);
+                result.community = runRandomOrder<Quality>(*consensus, min_gain, gamma, rng);
+                break;
+            }
+        }
+        runs.clear();
+        consensus.reset();
+
+        // El consenso solo contiene los núcleos estables; una última pasada sobre el grafo original, partiendo
+        // de él, recoloca los nodos que quedaron sueltos al descartar aristas.
+        std::seed_seq seq{seed};
+        std::mt19937 rng(seq);
+        result.community = runRandomOrder<Quality>(graph, min_gain, gamma, rng, &result.community);
+    }
+    double t2 = omp_get_wtime();
+
+    result.n_communities = countCommunities(result.community);
+    result.quality = qualityKernel<Quality>(graph, result.community, gamma);
+    result.consensus_seconds = t2 - t1;
+    result.seconds = t2 - t0;
+    return result;
+}
+
+void Algoritmo::runAsync(double min_gain, double gamma, QualityType quality) {
+    if (!network || network->getNNodes() == 0) {
+        return;
+    }
+    CompactGraph graph(*network);
+    std::vector<int> community = runAsync(graph, min_gain, gamma, verbose, quality);
+
+    // Volcamos las etiquetas densas sobre la partición
+    if (!partition->matches(*network)) partition->reset(*network);
+    for (int i = 0; i < graph.getNNodes(); ++i) {
+        partition->setCommunity(static_cast<unsigned int>(graph.getOriginalID(i)),
+                                static_cast<int>(graph.getOriginalID(community[i])));
+    }
+    partition->rebuild(*network);
+}
+
+std::vector<int> Algoritmo::runAsync(const CompactGraph& graph, double min_gain, double gamma, bool verbose,
+                                     QualityType quality) {
+    switch (quality) {
+    case QualityType::MODULARITY: return asyncKernel<ModularityQuality>(graph, min_gain, gamma, verbose);
+    case QualityType::RBER:       return asyncKernel<RBERQuality>(graph, min_gain, gamma, verbose);
+    default:                      return asyncKernel<CPMQuality>(graph, min_gain, gamma, verbose);
+    }
+}
+
+template <class Quality>
+std::vector<int> Algoritmo::asyncKernel(const CompactGraph& graph, double min_gain, double gamma, bool verbose) {
+    int N = graph.getNNodes();
+    std::vector<int> community(N);
+    std::iota(community.begin(), community.end(), 0);
+    if (N == 0 || graph.getTotalWeight() == 0.0) {
+        return community;
+    }
+
+    // Estado compartido: etiqueta de cada nodo y tamaño/grado total de cada comunidad, todo atómico.
+    // Las etiquetas se leen con accesos relajados: una lectura desfasada solo produce un movimiento
+    // peor, que se corrige al volver a evaluar el nodo (sus vecinos lo encolan al moverse).
+    std::unique_ptr<std::atomic<int>[]> labels(new std::atomic<int>[N]);
+    std::unique_ptr<std::atomic<long>[]> sizes(new std::atomic<long>[N]);
+    std::unique_ptr<std::atomic<double>[]> total_degrees(new std::atomic<double>[N]);
+    AsyncNodeQueue queue(static_cast<std::size_t>(N));
+    for (int i = 0; i < N; ++i) {
+        labels[i].store(i, std::memory_order_relaxed);
+        sizes[i].store(static_cast<long>(graph.getNodeSize(i)), std::memory_order_relaxed);
+        total_degrees[i].store(graph.getDegree(i), std::memory_order_relaxed);
+        queue.push(i);
+    }
+    const Quality quality(gamma, graph.getTotalWeight(), totalSize(graph));
+
+    // Cota de seguridad frente a oscilaciones por lecturas desfasadas: superado el nº máximo de
+    // movimientos, los nodos que se mueven ya no encolan a sus vecinos y la cola se vacía.
+    const unsigned long max_moves = static_cast<unsigned long>(ASYNC_MAX_MOVES_PER_NODE) * static_cast<unsigned long>(N);
+    std::atomic<unsigned long> movimientos{0};
+    std::atomic<unsigned long> evaluaciones{0};
+
+    int P = omp_get_max_threads();
+    if (P < 1) P = 1;
+    std::vector<NeighborAccumulator> thread_weights(P);
+    std::vector<CandidateBuffer> thread_candidates(P);
+
+    double t0 = omp_get_wtime();
+    #pragma omp parallel num_threads(P)
+    {
+        int tid = omp_get_thread_num();
+        NeighborAccumulator& comm_weight = thread_weights[tid];
+        comm_weight.resize(N);
+        CandidateBuffer& candidates = thread_candidates[tid];
+        unsigned long local_evaluations = 0;
+
+        int i;
+        while (true) {
+            if (!queue.pop(i)) {
+                // Sin barrera entre barridos: se termina solo cuando no queda nada en cola ni en evaluación
+                if (queue.isQuiescent()) break;
+                std::this_thread::yield();
+                continue;
+            }
+            ++local_evaluations;
+
+            int current_comm = labels[i].load(std::memory_order_relaxed);
+            for (std::size_t e = graph.begin(i); e < graph.end(i); ++e) {
+                comm_weight.add(labels[graph.neighbor(e)].load(std::memory_order_relaxed), graph.weight(e));
+            }
+
+            double k_i_in_i = comm_weight.get(current_comm);
+            double size_i = static_cast<double>(sizes[current_comm].load(std::memory_order_relaxed));
+            long node_size = static_cast<long>(graph.getNodeSize(i));
+            double n_i = static_cast<double>(node_size);
+            // Los contadores son atómicos y otros hilos los modifican: se copian a arrays contiguos antes de
+            // buscar la mejor comunidad con una sola reducción vectorial
+            candidates.clear();
+            for (int comm_j : comm_weight.getKeys()) {
+                if (comm_j == current_comm) continue;
+                candidates.add(comm_j, comm_weight.get(comm_j),
+                               static_cast<double>(sizes[comm_j].load(std::memory_order_relaxed)),
+                               total_degrees[comm_j].load(std::memory_order_relaxed));
+            }
+            comm_weight.clear();
+            LinearGain gain = quality.linearGain(k_i_in_i, n_i, graph.getDegree(i), size_i,
+                                                 total_degrees[current_comm].load(std::memory_order_relaxed));
+            double best_dQ = 0.0;
+            int best_comm = candidates.best(gain, best_dQ);
+
+            if (best_comm != -1 && best_dQ > min_gain) {
+                // Solo este hilo evalúa el nodo i, así que su etiqueta y su aportación a los contadores
+                // se actualizan sin conflictos; los contadores siguen siendo exactos.
+                labels[i].store(best_comm, std::memory_order_relaxed);
+                sizes[current_comm].fetch_sub(node_size, std::memory_order_relaxed);
+                sizes[best_comm].fetch_add(node_size, std::memory_order_relaxed);
+                atomicAdd(total_degrees[current_comm], -graph.getDegree(i));
+                atomicAdd(total_degrees[best_comm], graph.getDegree(i));
+
+                if (movimientos.fetch_add(1, std::memory_order_relaxed) < max_moves) {
+                    // Los vecinos que no están en la nueva comunidad pueden querer seguir al nodo
+                    for (std::size_t e = graph.begin(i); e < graph.end(i); ++e) {
+                        int j = graph.neighbor(e);
+                        if (labels[j].load(std::memory_order_relaxed) != best_comm) {
+                            queue.push(j);
+                        }
+                    }
+                }
+            }
+            queue.finish(i);
+        }
+        evaluaciones.fetch_add(local_evaluations, std::memory_order_relaxed);
+    } // fin región paralela
+    double t1 = omp_get_wtime();
+
+    for (int i = 0; i < N; ++i) {
+        community[i] = labels[i].load(std::memory_order_relaxed);
+    }
+    if (verbose) {
+        std::cout << "Tiempo de ejecucion del movimiento local asincrono: " << (t1 - t0) << " segundos." << std::endl;
+        std::cout << "Evaluaciones: " << evaluaciones.load() << " | Movimientos aplicados: " << movimientos.load()
+                  << std::endl;
+    }
+    return community;
 }
 
 void Algoritmo::mergeCommunities() {
     if (!network || network->getNNodes() == 0) {
         return;
     }
-    // Agrupamos los nodos por su comunidad
-    std::map<int, std::vector<Node*>> communities;
-    for (const auto &pair : network->getNodesMap()) {
-        Node* node = pair.second.get();
+    if (!partition->matches(*network)) partition->reset(*network);
+    std::vector<int> coarse_of;
+    std::unique_ptr<Network> coarse = buildCoarseNetwork(coarse_of);
+    // La red pasa a ser la agregada; sus nodos y aristas viven en los almacenes que se mueven con ella
+    *network = std::move(*coarse);
+    partition->reset(*network);
+    if (dendrogram) dendrogram->addLevel(std::move(coarse_of));
+}
+
+std::unique_ptr<Network> Algoritmo::buildCoarseNetwork(std::vector<int>& coarse_of) {
+    ScopedTimer merge_timer(telemetry, Phase::MERGE);
+    std::unique_ptr<Network> coarse(new Network());
+    const std::size_t id_bound = network->getIdBound();
+    coarse_of.assign(id_bound, -1);
+
+    // Cada comunidad recibe un ID denso en orden de primera aparición; contamos sus nodos y el grado de sus
+    // miembros, que sirve para repartir entre los hilos rangos de supernodos con un nº de aristas parecido
+    std::vector<int> coarse_of_comm(id_bound, -1);
+    std::vector<std::size_t> group_offsets(1, 0);
+    std::vector<std::size_t> group_degree;
+    for (const auto& ptr : network->getNodes()) {
+        Node* node = ptr.get();
         if (!node) continue;
-        int comm_id = node->getCommunity();
-        communities[comm_id].push_back(node);
+        int comm_id = partition->getCommunity(node->getID());
+        if (coarse_of_comm[comm_id] == -1) {
+            coarse_of_comm[comm_id] = static_cast<int>(group_degree.size());
+            group_offsets.push_back(0);
+            group_degree.push_back(0);
+        }
+        int c = coarse_of_comm[comm_id];
+        coarse_of[node->getID()] = c;
+        ++group_offsets[c + 1];
+        group_degree[c] += node->getDegree();
+    }
+    const std::size_t C = group_degree.size();
+    for (std::size_t c = 0; c < C; ++c) {
+        group_offsets[c + 1] += group_offsets[c];
+    }
+    // Nodos agrupados por supernodo (orden por ID dentro de cada grupo)
+    std::vector<Node*> grouped(group_offsets[C]);
+    {
+        std::vector<std::size_t> cursor(group_offsets.begin(), group_offsets.end() - 1);
+        for (const auto& ptr : network->getNodes()) {
+            if (ptr) grouped[cursor[coarse_of[ptr->getID()]]++] = ptr.get();
+        }
+    }
+
+    // Rangos contiguos de supernodos, uno por partición, con una suma de grados parecida
+    int P = omp_get_max_threads();
+    if (P < 1) P = 1;
+    std::vector<std::size_t> bounds(1, 0);
+    std::vector<int> range_of(C);
+    {
+        std::size_t total_degree = 0;
+        for (std::size_t d : group_degree) total_degree += d;
+        std::size_t acumulado = 0;
+        for (std::size_t c = 0; c < C; ++c) {
+            range_of[c] = static_cast<int>(bounds.size()) - 1;
+            acumulado += group_degree[c];
+            if (static_cast<int>(bounds.size()) < P && acumulado * P >= total_degree * bounds.size()) {
+                bounds.push_back(c + 1);
+            }
+        }
+        if (bounds.back() != C) bounds.push_back(C);
     }
+    const int R = static_cast<int>(bounds.size()) - 1;
 
-    // Calculamos el ID máximo actual para crear nodos con IDs únicos
-    unsigned int max_node_id = 0;
-    for (const auto &pair : network->getNodesMap()) {
-        max_node_id = std::max(max_node_id, pair.first);
+    // Tripletas (supernodo menor, supernodo mayor, peso) de cada arista. Cada hilo recorre un bloque
+    // contiguo de aristas y las deja en la partición de su supernodo menor, en orden de ID de arista.
+    // Las aristas internas de una comunidad (y los bucles) dan tripletas (c, c, w): el bucle del supernodo.
+    struct Triple {
+        int u;    // supernodo menor
+        int v;    // supernodo mayor
+        double w; // peso de la arista
+    };
+    const auto& edges = network->getEdges();
+    const std::size_t E = edges.size();
+    std::vector<std::vector<std::vector<Triple>>> emitted(P, std::vector<std::vector<Triple>>(R));
+    #pragma omp parallel for schedule(static) num_threads(P)
+    for (int t = 0; t < P; ++t) {
+        std::size_t first = E * t / P;
+        std::size_t last = E * (t + 1) / P;
+        for (std::size_t e = first; e < last; ++e) {
+            Edge* edge = edges[e].get();
+            if (!edge) continue;
+            int u = coarse_of[edge->getOrigin()->getID()];
+            int v = coarse_of[edge->getDestiny()->getID()];
+            if (u > v) std::swap(u, v);
+            emitted[t][range_of[u]].push_back(Triple{u, v, edge->getWeight()});
+        }
     }
-    unsigned int next_new_id = max_node_id + 1;
 
-    for (auto &entry : communities) { // Procesamos cada comunidad
-        int comm_id = entry.first;
-        std::vector<Node*> &comm_nodes = entry.second;
-        if (comm_nodes.size() <= 1) {
-            continue;
+    // Reducción por partición: ordenación por conteo según el supernodo menor (estable, así que cada
+    // supernodo ve sus aristas en orden de ID) y suma de los pesos por vecino con un acumulador disperso.
+    // El resultado no depende del nº de hilos.
+    std::vector<std::vector<Triple>> reduced(R);
+    #pragma omp parallel num_threads(P)
+    {
+        NeighborAccumulator acc(C);
+        std::vector<std::size_t> offsets;
+        std::vector<Triple> sorted;
+        #pragma omp for schedule(dynamic, 1)
+        for (int r = 0; r < R; ++r) {
+            std::size_t lo = bounds[r];
+            std::size_t hi = bounds[r + 1];
+            offsets.assign(hi - lo + 1, 0);
+            for (int t = 0; t < P; ++t) {
+                for (const Triple& tr : emitted[t][r]) ++offsets[tr.u - lo + 1];
+            }
+            for (std::size_t k = 0; k < hi - lo; ++k) offsets[k + 1] += offsets[k];
+            sorted.resize(offsets[hi - lo]);
+            for (int t = 0; t < P; ++t) {
+                for (const Triple& tr : emitted[t][r]) sorted[offsets[tr.u - lo]++] = tr;
+                std::vector<Triple>().swap(emitted[t][r]);
+            }
+            // Tras la dispersión offsets[k] es el final del supernodo lo + k
+            std::size_t begin = 0;
+            for (std::size_t k = 0; k < hi - lo; ++k) {
+                acc.clear();
+                for (std::size_t x = begin; x < offsets[k]; ++x) acc.add(sorted[x].v, sorted[x].w);
+                int u = static_cast<int>(lo + k);
+                for (int v : acc.getKeys()) reduced[r].push_back(Triple{u, v, acc.get(v)});
+                begin = offsets[k];
+            }
         }
-        std::unordered_set<Node*> communitySet(comm_nodes.begin(), comm_nodes.end());
-        Node* n_merge = network->addNode(next_new_id++); // Nuevo ID siguiente
-        n_merge->setCommunity(comm_id);
+    }
+
+    // Construcción de la red agregada de una vez: nodos, listas de adyacencia con su tamaño final,
+    // tamaños (en paralelo, cada supernodo es independiente) y aristas
+    std::size_t n_coarse_edges = 0;
+    std::vector<std::size_t> coarse_degree(C, 0);
+    for (const std::vector<Triple>& part : reduced) {
+        n_coarse_edges += part.size();
+        for (const Triple& tr : part) {
+            ++coarse_degree[tr.u];
+            if (tr.v != tr.u) ++coarse_degree[tr.v];
+        }
+    }
+    coarse->reserve(C, n_coarse_edges);
+    for (std::size_t c = 0; c < C; ++c) {
+        coarse->addNode(static_cast<unsigned int>(c))->reserveEdges(coarse_degree[c]);
+    }
+    #pragma omp parallel for schedule(static)
+    for (std::size_t c = 0; c < C; ++c) {
+        // El tamaño de un supernodo es el nº de nodos originales de sus nodos; qué nodos son lo guarda el
+        // Dendrogram (coarse_of), sin copiar listas de miembros
+        unsigned int size = 0;
+        for (std::size_t x = group_offsets[c]; x < group_offsets[c + 1]; ++x) {
+            size += grouped[x]->getSize();
+        }
+        coarse->getNode(static_cast<unsigned int>(c))->setSize(size);
+    }
+    for (const std::vector<Triple>& part : reduced) {
+        for (const Triple& tr : part) {
+            coarse->addEdge(static_cast<unsigned int>(tr.u), static_cast<unsigned int>(tr.v), tr.w);
+        }
+    }
+    if (TELEMETRY_ENABLED && telemetry) {
+        telemetry->add(Counter::MERGES);
+        telemetry->add(Counter::MERGED_NODES, network->getNNodes() - coarse->getNNodes());
+    }
+    return coarse;
+}
+
+std::unordered_map<int, int> Algoritmo::refineCommunities(double gamma, QualityType quality) {
+    switch (quality) {
+    case QualityType::MODULARITY: return refineKernel<ModularityQuality>(gamma);
+    case QualityType::RBER:       return refineKernel<RBERQuality>(gamma);
+    default:                      return refineKernel<CPMQuality>(gamma);
+    }
+}
 
-        // Agregamos los miembros originales al nuevo nodo
-        for (Node* node_i : comm_nodes) {
-            if (!node_i) continue;
+template <class Quality>
+std::unordered_map<int, int> Algoritmo::refineKernel(double gamma) {
+    std::unordered_map<int, int> refined_to_community;
+    if (!network || network->getNNodes() == 0) {
+        return refined_to_community;
+    }
+    CompactGraph graph(*network);
+    int N = graph.getNNodes();
+    const Quality quality(gamma, graph.getTotalWeight(), totalSize(graph));
 
-            const auto &miembros_i = node_i->getMembers();
-            if (!miembros_i.empty()) {
-                // Si node_i ya era un supernodo, heredamos todos sus miembros
-                for (unsigned int mid : miembros_i) {
-                    n_merge->addMember(mid);
+    // Comunidad (no refinada) de cada nodo y agrupación de los nodos por comunidad
+    std::vector<int> community(N);
+    std::map<int, std::vector<int>> groups;
+    for (int i = 0; i < N; ++i) {
+        community[i] = partition->getCommunity(static_cast<unsigned int>(graph.getOriginalID(i)));
+        groups[community[i]].push_back(i);
+    }
+    std::vector<std::vector<int>*> work;
+    work.reserve(groups.size());
+    for (auto& entry : groups) {
+        if (entry.second.size() > 1) work.push_back(&entry.second);
+    }
+    // Las comunidades más grandes primero, para equilibrar la carga entre hilos
+    std::sort(work.begin(), work.end(), [](const std::vector<int>* a, const std::vector<int>* b) {
+        return a->size() > b->size();
+    });
+
+    // Subcomunidad refinada de cada nodo, identificada por el índice denso de su nodo representante
+    std::vector<int> refined(N);
+    std::iota(refined.begin(), refined.end(), 0);
+    std::vector<double> sub_size(N);      // tamaño de cada subcomunidad
+    std::vector<double> sub_degree(N);    // grado total de cada subcomunidad
+    std::vector<double> sub_external(N);  // peso desde la subcomunidad al resto de su comunidad
+    std::vector<double> node_internal(N); // peso desde el nodo al resto de su comunidad
+    std::vector<char> singleton(N, 1);    // el nodo sigue solo en su subcomunidad
+
+    int P = omp_get_max_threads();
+    if (P < 1) P = 1;
+    std::vector<NeighborAccumulator> thread_weights(P);
+
+    // Las comunidades son independientes entre sí: cada hilo refina comunidades completas y solo
+    // escribe en las posiciones de sus nodos.
+    #pragma omp parallel
+    {
+        int tid = omp_get_thread_num();
+        NeighborAccumulator& sub_weights = thread_weights[tid];
+        sub_weights.resize(N);
+
+        #pragma omp for schedule(dynamic, 1)
+        for (std::size_t c = 0; c < work.size(); ++c) {
+            const std::vector<int>& members = *work[c];
+            int comm = community[members.front()];
+
+            double size_c = 0.0;
+            double degree_c = 0.0;
+            for (int v : members) {
+                double k_v_in = 0.0;
+                for (std::size_t e = graph.begin(v); e < graph.end(v); ++e) {
+                    if (community[graph.neighbor(e)] == comm) k_v_in += graph.weight(e);
                 }
-            } else {
-                // Si no tuviera members, añadimos su propio ID
-                n_merge->addMember(node_i->getID());
+                node_internal[v] = k_v_in;
+                sub_external[v] = k_v_in;
+                sub_size[v] = static_cast<double>(graph.getNodeSize(v));
+                sub_degree[v] = graph.getDegree(v);
+                size_c += sub_size[v];
+                degree_c += sub_degree[v];
+            }
+
+            for (int v : members) {
+                if (!singleton[v]) continue;
+                double n_v = static_cast<double>(graph.getNodeSize(v));
+                double k_v = graph.getDegree(v);
+
+                // Solo se mueven nodos bien conectados con su comunidad: E(v, C-v) >= peso esperado entre v y C-v
+                // (gamma * n_v * (|C| - n_v) en el CPM)
+                if (node_internal[v] < quality.expected(n_v, k_v, size_c - n_v, degree_c - k_v)) continue;
+
+                sub_weights.clear();
+                for (std::size_t e = graph.begin(v); e < graph.end(v); ++e) {
+                    int u = graph.neighbor(e);
+                    if (community[u] == comm) sub_weights.add(refined[u], graph.weight(e));
+                }
+
+                // Mejor subcomunidad bien conectada: E(T, C-T) >= peso esperado entre T y C-T
+                int best_sub = -1;
+                double best_gain = 0.0;
+                for (int t : sub_weights.getKeys()) {
+                    if (t == refined[v]) continue;
+                    if (sub_external[t] < quality.expected(sub_size[t], sub_degree[t], size_c - sub_size[t],
+                                                           degree_c - sub_degree[t])) continue;
+                    double gain = sub_weights.get(t) - quality.expected(n_v, k_v, sub_size[t], sub_degree[t]);
+                    if (gain >= 0.0 && (best_sub == -1 || gain > best_gain)) {
+                        best_gain = gain;
+                        best_sub = t;
+                    }
+                }
+                if (best_sub == -1) continue;
+
+                // v se une a la subcomunidad best_sub
+                sub_external[best_sub] += node_internal[v] - 2.0 * sub_weights.get(best_sub);
+                sub_size[best_sub] += n_v;
+                sub_degree[best_sub] += k_v;
+                sub_size[v] = 0.0;
+                sub_degree[v] = 0.0;
+                refined[v] = best_sub;
+                singleton[v] = 0;
+                singleton[best_sub] = 0;
             }
         }
-        std::unordered_map<Node*, double> externalWeights; // Mapa de pesos externos: vecino -> peso total acumulado
-        // Recorremos las aristas de los nodos de la comunidad
-        for (Node* node_i : comm_nodes) {
-            if (!node_i) continue;
+    } // fin región paralela
 
-            const auto &adjList = node_i->getAdjList();
-            for (Edge* adjEdge : adjList) {
-                if (!adjEdge) continue;
+    // Cada nodo pasa a la subcomunidad refinada (con el ID original de su representante)
+    for (int i = 0; i < N; ++i) {
+        int refined_id = static_cast<int>(graph.getOriginalID(refined[i]));
+        partition->setCommunity(static_cast<unsigned int>(graph.getOriginalID(i)), refined_id);
+        refined_to_community[refined_id] = community[i];
+    }
+    partition->rebuild(*network);
+    return refined_to_community;
+}
 
-                Node* neighbor = adjEdge->getOpposite(node_i);
-                if (!neighbor) continue;
-                // Si el vecino está en la misma comunidad, lo ignoramos
-                if (communitySet.find(neighbor) != communitySet.end()) {
-                    continue;
+std::vector<int> Algoritmo::runMultilevel(double gamma, double min_gain, MoveMode mode, int max_levels, bool refine,
+                                          QualityType quality) {
+    std::vector<int> result;
+    if (!network || network->getNNodes() == 0) {
+        return result;
+    }
+    if (!partition->matches(*network)) partition->reset(*network);
+
+    // Red y partición del nivel actual: el primer nivel trabaja sobre la red de entrada (solo lectura) y
+    // los siguientes sobre redes agregadas propias. Cada agregación se registra en la jerarquía, cuyo
+    // nivel 0 son los nodos de la red de entrada.
+    Network* level_network = network;
+    std::unique_ptr<Network> coarse_network;
+    Partition level_partition(*network);
+    hierarchy.clear();
+    int level = 0;
+
+    // Puntos de control: tras cada movimiento local y tras cada agregación se guarda (en segundo plano)
+    // el estado necesario para continuar desde ahí: red del nivel, partición, dendrograma y nivel
+    CheckpointInfo run_info;
+    run_info.quality = static_cast<std::uint32_t>(quality);
+    run_info.mode = static_cast<std::uint32_t>(mode);
+    run_info.refine = refine ? 1u : 0u;
+    run_info.max_levels = max_levels;
+    run_info.gamma = gamma;
+    run_info.min_gain = min_gain;
+    run_info.input_bound = network->getIdBound();
+    run_info.input_nodes = network->getNNodes();
+    std::unique_ptr<CheckpointWriter> checkpoints;
+    if (!checkpoint_file.empty()) {
+        checkpoints.reset(new CheckpointWriter(checkpoint_file, checkpoint_interval));
+    }
+    auto checkpoint = [&](CheckpointStage stage) {
+        if (!checkpoints || !checkpoints->due()) return;
+        CheckpointInfo info = run_info;
+        info.stage = stage;
+        info.level = static_cast<std::uint32_t>(level);
+        Network* stored = (level_network == network) ? nullptr : level_network;
+        checkpoints->submit(serializeCheckpoint(info, hierarchy, stored, *level_network, level_partition));
+    };
+
+    // Al reanudar se continúa desde la etapa guardada: tras un movimiento local se pasa directamente a la
+    // agregación de ese nivel
+    bool skip_run = false;
+    if (checkpoint_resume && !checkpoint_file.empty()) {
+        CheckpointInfo saved;
+        Dendrogram saved_hierarchy;
+        std::unique_ptr<Network> saved_network;
+        std::vector<int> labels;
+        if (loadCheckpoint(checkpoint_file, saved, saved_hierarchy, saved_network, labels)) {
+            Network* resumed = saved_network ? saved_network.get() : network;
+            bool consistent = saved.sameRun(run_info) && labels.size() == resumed->getIdBound() &&
+                              (saved_hierarchy.getNLevels() == 0 ? !saved_network
+                                                                 : saved_hierarchy.getIdBound() == network->getIdBound());
+            for (int label : labels) {
+                consistent = consistent && label < static_cast<int>(labels.size());
+            }
+            if (consistent) {
+                hierarchy = std::move(saved_hierarchy);
+                if (saved_network) {
+                    coarse_network = std::move(saved_network);
+                    level_network = coarse_network.get();
+                }
+                level_partition.reset(*level_network);
+                for (const auto& ptr : level_network->getNodes()) {
+                    if (ptr && labels[ptr->getID()] >= 0) {
+                        level_partition.setCommunity(ptr->getID(), labels[ptr->getID()]);
+                    }
+                }
+                level_partition.rebuild(*level_network);
+                level = static_cast<int>(saved.level);
+                skip_run = (saved.stage == CheckpointStage::AFTER_RUN);
+                if (verbose) {
+                    std::cout << "Reanudando desde " << checkpoint_file << ": nivel " << level << ", "
+                              << level_network->getNNodes() << " nodos"
+                              << (skip_run ? " (movimiento local completado)" : "") << std::endl;
                 }
-                // Acumular peso hacia ese vecino externo
-                externalWeights[neighbor] += adjEdge->getWeight();
+            } else {
+                std::cerr << "Aviso: El punto de control " << checkpoint_file
+                          << " no corresponde a esta red o a estos parametros; se empieza desde el principio." << std::endl;
             }
         }
-        // Crear aristas (n_merge, neighbor, total_w) en la red
-        for (auto &nw : externalWeights) {
-            Node* neighbor = nw.first;
-            double total_w = nw.second;
-            if (!neighbor) continue;
+    }
 
-            network->addEdge(n_merge->getID(), neighbor->getID(), total_w);
+    double t0 = omp_get_wtime();
+    while (skip_run || max_levels <= 0 || level < max_levels) {
+        std::size_t nodes_before = level_network->getNNodes();
+        Algoritmo level_algo(level_network, &level_partition);
+        level_algo.setTelemetry(telemetry);
+        level_algo.setVerbose(verbose);
+
+        // Fase 1: movimiento local de nodos sobre la red del nivel actual. Con refinamiento, a partir
+        // del segundo nivel se parte de la partición no refinada heredada del nivel anterior.
+        if (!skip_run) {
+            level_algo.run(min_gain, gamma, mode, !refine || level == 0, quality);
+            ++level;
+            checkpoint(CheckpointStage::AFTER_RUN);
+        }
+        skip_run = false;
+
+        std::size_t n_communities = level_partition.getNCommunities();
+        if (n_communities == nodes_before) {
+            if (verbose) std::cout << "Nivel " << level << ": " << nodes_before << " nodos, sin cambios" << std::endl;
+            break; // Cada nodo es su propia comunidad: convergencia
+        }
+
+        // Fase 2 (opcional): refinamiento de cada comunidad en subcomunidades bien conectadas
+        std::unordered_map<int, int> refined_to_community;
+        if (refine) {
+            refined_to_community = level_algo.refineCommunities(gamma, quality);
+        }
+
+        // Fase 3: agregación de cada comunidad (o subcomunidad refinada) en un supernodo
+        std::vector<int> coarse_of;
+        std::unique_ptr<Network> next_network = level_algo.buildCoarseNetwork(coarse_of);
+        Partition next_partition(*next_network);
+
+        // Con refinamiento, los supernodos heredan la comunidad no refinada para sembrar el siguiente nivel
+        // (identificada por el primer supernodo que la contiene)
+        if (refine) {
+            std::unordered_map<int, int> first_coarse;
+            for (const auto& ptr : level_network->getNodes()) {
+                if (!ptr) continue;
+                int comm = refined_to_community[level_partition.getCommunity(ptr->getID())];
+                int coarse_id = coarse_of[ptr->getID()];
+                auto it = first_coarse.emplace(comm, coarse_id).first;
+                next_partition.setCommunity(static_cast<unsigned int>(coarse_id), it->second);
+            }
+            next_partition.rebuild(*next_network);
+        }
+        hierarchy.addLevel(std::move(coarse_of));
+
+        std::size_t nodes_after = next_network->getNNodes();
+        if (verbose) {
+            std::cout << "Nivel " << level << ": " << nodes_before << " nodos -> " << n_communities
+                      << " comunidades -> " << nodes_after << " nodos" << std::endl;
         }
-        // Eliminamos los nodos originales de la comunidad
-        for (Node* node_i : comm_nodes) {
-            if (!node_i) continue;
-            unsigned int old_id = node_i->getID();
-            network->removeNode(old_id);
+        coarse_network = std::move(next_network);
+        level_network = coarse_network.get();
+        level_partition = std::move(next_partition);
+        if (nodes_after == nodes_before) {
+            break; // Ningún nodo se ha fusionado: no se puede avanzar más
         }
+        checkpoint(CheckpointStage::LEVEL_START);
+    }
+    if (checkpoints) checkpoints->wait();
+    double t1 = omp_get_wtime();
+    if (verbose) {
+        std::cout << "Tiempo total multinivel: " << (t1 - t0) << " segundos (" << level << " niveles)." << std::endl;
+    }
+
+    // Partición final sobre la red de entrada (extendida en paralelo desde el último nivel): cada comunidad
+    // se identifica con el ID de su primer nodo
+    std::vector<int> top_labels(level_network->getIdBound(), -1);
+    for (const auto& ptr : level_network->getNodes()) {
+        if (ptr) top_labels[ptr->getID()] = level_partition.getCommunity(ptr->getID());
     }
+    std::vector<int> community_of = hierarchy.flattenLabels(top_labels);
+    std::vector<int> representative(top_labels.size(), -1);
+    for (const auto& ptr : network->getNodes()) {
+        if (!ptr) continue;
+        int& rep = representative[community_of[ptr->getID()]];
+        if (rep == -1) rep = static_cast<int>(ptr->getID());
+        partition->setCommunity(ptr->getID(), rep);
+    }
+    partition->rebuild(*network);
+
+    // La comunidad de cada nodo de la red de entrada se extiende a los nodos originales que contiene
+    // (si la red ya era el resultado de agregaciones registradas en el dendrograma de la red)
+    result.assign(network->getIdBound(), -1);
+    for (const auto& ptr : network->getNodes()) {
+        if (ptr) result[ptr->getID()] = partition->getCommunity(ptr->getID());
+    }
+    if (dendrogram && dendrogram->getNLevels() > 0) {
+        result = dendrogram->flattenLabels(result);
+    }
+    return result;
 }
+
 } // namespace networkStructure
@@ -4,12 +4,63 @@
 #include "Network.h"
 #include "Node.h"
 #include "Edge.h"
+#include "NeighborAccumulator.h"
+#include "CompactGraph.h"
+#include "WorkScheduler.h"
+#include "Partition.h"
+#include "QualityFunction.h"
+#include "Telemetry.h"
+#include "Dendrogram.h"
 
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <memory>
+#include <random>
+#include <string>
 
 namespace networkStructure {
+/**
+ * @enum MoveMode
+ * @brief Estrategia con la que run() aplica los movimientos encontrados en cada iteración.
+ */
+enum class MoveMode {
+    SPLICE, ///< Se aplica un único movimiento por iteración: el mejor ΔQ global entre todos los hilos.
+    BATCH   ///< Cada hilo propone todos los movimientos de mejora de su rango y se aplican en lote tras revalidar su ΔQ.
+};
+
+/**
+ * @struct ResolutionResult
+ * @brief Resultado de una ejecución del barrido de resolución (sweepResolution()).
+ */
+struct ResolutionResult {
+    double gamma = 0.0;             ///< Parámetro de resolución usado.
+    std::size_t n_communities = 0;  ///< Nº de comunidades obtenidas.
+    double quality = 0.0;           ///< Calidad de la partición (ver Algoritmo::evaluateQuality()).
+    double seconds = 0.0;           ///< Tiempo de la optimización.
+};
+
+/**
+ * @struct EnsembleResult
+ * @brief Resultado de una ejecución por consenso (runEnsemble()).
+ * @details Los vectores run_* tienen una entrada por cada ejecución aleatoria completada (puede haber menos
+ * de las pedidas si se agota el presupuesto de tiempo).
+ */
+struct EnsembleResult {
+    std::vector<int> community;                ///< Partición de consenso, indexada por índice denso.
+    std::size_t n_communities = 0;             ///< Nº de comunidades de la partición de consenso.
+    double quality = 0.0;                      ///< Calidad de la partición de consenso sobre el grafo original.
+    std::vector<double> run_seconds;           ///< Tiempo de cada ejecución aleatoria.
+    std::vector<double> run_quality;           ///< Calidad de cada ejecución aleatoria.
+    std::vector<std::size_t> run_communities;  ///< Nº de comunidades de cada ejecución aleatoria.
+    double quality_mean = 0.0;                 ///< Media de run_quality.
+    double quality_stddev = 0.0;               ///< Desviación típica de run_quality.
+    double quality_min = 0.0;                  ///< Mínimo de run_quality.
+    double quality_max = 0.0;                  ///< Máximo de run_quality.
+    double consensus_seconds = 0.0;            ///< Tiempo de construir y reagrupar el grafo de consenso.
+    double seconds = 0.0;                      ///< Tiempo total.
+};
+
 /**
  * @class Algoritmo
  * @brief Implementa la detección de comunidades mediante el Constant Potts Model (CPM).
@@ -17,51 +68,367 @@ namespace networkStructure {
  * En cada iteración analiza los nodos de la red y los desplaza a la comunidad vecina
  * que proporcione la mayor mejora en la función de calidad del modelo. El proceso
  * continúa hasta que no se producen más movimientos que incrementen dicha calidad.
+ *
+ * La función de calidad (CPM por defecto, modularidad o Reichardt-Bornholdt, ver QualityType) se elige
+ * con el último parámetro de cada método. Cada método público solo selecciona una vez la versión
+ * especializada de su algoritmo (una plantilla privada instanciada con CPMQuality, ModularityQuality o
+ * RBERQuality), así que el bucle interno calcula la ganancia en línea, sin comprobar la función elegida.
  */
 class Algoritmo {
 public:
     /**
      * @brief Constructor de la clase.
+     * @details El algoritmo usa una partición propia, inicialmente con cada nodo en su propia comunidad.
      * @param net Puntero a la red (Network) sobre la que se ejecutará el algoritmo.
      */
     Algoritmo(networkStructure::Network* net);
 
+    /**
+     * @brief Constructor con una partición externa.
+     * @details Los métodos de optimización leen y escriben las comunidades en 'part' y tratan la red como
+     * topología de solo lectura, así que varios Algoritmo con particiones distintas pueden ejecutarse a la
+     * vez sobre la misma Network. La excepción es mergeCommunities(), que reescribe la red.
+     * @param net Puntero a la red (Network) sobre la que se ejecutará el algoritmo.
+     * @param part Partición de la red; debe existir mientras se use el algoritmo.
+     */
+    Algoritmo(networkStructure::Network* net, Partition* part);
+
+    /**
+     * @brief Partición (comunidad de cada nodo y agregados) que lee y escribe el algoritmo.
+     */
+    Partition& getPartition() { return *partition; }
+
     /**
      * @brief Ejecuta el algoritmo de detección de comunidades usando Constant Potts Model (CPM).
      * @param min_gain Umbral mínimo de ganancia de calidad para aceptar un movimiento.
      * @param gamma Parámetro de resolución del CPM (controla el tamaño de las comunidades).
+     * @param mode Estrategia de aplicación de movimientos (SPLICE por defecto).
+     * @param reset_communities Si es true, cada nodo empieza en su propia comunidad; si es false, se parte
+     * de la comunidad que ya tenga asignada cada nodo.
+     * @param quality Función de calidad a optimizar.
+     * @details En modo BATCH cada barrido puede mover miles de nodos. Los movimientos propuestos
+     * en paralelo se ordenan por ΔQ y se aplican secuencialmente, recalculando antes su ΔQ con las
+     * etiquetas y tamaños ya actualizados; solo se aplican los que siguen superando min_gain.
+     * Los nodos de cada barrido se reparten con un WorkScheduler (bloques con robo de trabajo) y al
+     * terminar se informa del tiempo ocupado e inactivo de cada hilo (ver getThreadStats()).
+     *
+     * Solo el primer barrido evalúa todos los nodos. Después se mantiene un conjunto de nodos activos (mapa
+     * de bits + lista sin repetidos): un nodo se vuelve a evaluar cuando algún vecino cambia de comunidad o
+     * cuando tenía una mejora que no llegó a aplicarse. El algoritmo termina cuando no quedan nodos activos.
+     */
+    void run(double min_gain = 0, double gamma = 1.0, MoveMode mode = MoveMode::SPLICE, bool reset_communities = true,
+             QualityType quality = QualityType::CPM);
+
+    /**
+     * @brief Ejecuta la optimización local CPM sobre una instantánea CSR de la red.
+     * @details Construye un CompactGraph en O(n+m) y realiza los barridos en modo BATCH trabajando
+     * únicamente con índices densos 0..n-1 y un vector plano de etiquetas, sin recorrer punteros a
+     * Node ni Edge en el bucle principal. Al terminar, escribe la comunidad final en la partición
+     * (usando como identificador de comunidad el ID original de uno de sus nodos).
+     * @param min_gain Umbral mínimo de ganancia de calidad para aceptar un movimiento.
+     * @param gamma Parámetro de resolución del CPM.
+     * @param quality Función de calidad a optimizar.
+     */
+    void runCompact(double min_gain = 0, double gamma = 1.0, QualityType quality = QualityType::CPM);
+
+    /**
+     * @brief Ejecuta la optimización local CPM directamente sobre una instantánea CSR.
+     * @details No necesita una Network: sirve también para grafos cargados desde un fichero binario
+     * proyectado en memoria (CompactGraph::loadBinary()). Usa el mismo conjunto de nodos activos que run().
+     * @param graph Grafo CSR de entrada (solo lectura).
+     * @param min_gain Umbral mínimo de ganancia de calidad para aceptar un movimiento.
+     * @param gamma Parámetro de resolución del CPM.
+     * @param verbose Si es true, imprime el tiempo, las iteraciones y los movimientos.
+     * @param quality Función de calidad a optimizar.
+     * @return Comunidad de cada nodo, indexada por índice denso (el ID de comunidad es el índice de uno de sus nodos).
+     */
+    static std::vector<int> runCompact(const CompactGraph& graph, double min_gain = 0, double gamma = 1.0,
+                                       bool verbose = true, QualityType quality = QualityType::CPM);
+
+    /**
+     * @brief Calidad CPM de una partición: suma sobre las comunidades de (peso interno - gamma * n_c * (n_c - 1) / 2).
+     * @details El peso interno cuenta cada arista una vez e incluye los bucles; n_c es la suma de los tamaños
+     * de los nodos de la comunidad. Difiere de la función que optimiza run() solo en una constante.
+     * @param graph Grafo CSR.
+     * @param community Comunidad de cada nodo (índices densos en [0, n)).
+     * @param gamma Parámetro de resolución del CPM.
+     */
+    static double cpmQuality(const CompactGraph& graph, const std::vector<int>& community, double gamma);
+
+    /**
+     * @brief Calidad de una partición según la función elegida: suma sobre las comunidades de
+     * (peso interno - penalización del modelo nulo), ver CPMQuality::penalty().
+     * @param graph Grafo CSR.
+     * @param community Comunidad de cada nodo (índices densos en [0, n)).
+     * @param gamma Parámetro de resolución.
+     * @param quality Función de calidad.
+     */
+    static double evaluateQuality(const CompactGraph& graph, const std::vector<int>& community, double gamma,
+                                  QualityType quality);
+
+    /**
+     * @brief Barrido del parámetro de resolución sobre un único grafo cargado una sola vez.
+     * @details Ejecuta runCompact() para cada gamma de forma concurrente: cada ejecución tiene su propio
+     * vector de etiquetas y comparte el grafo en modo solo lectura; los hilos se reparten entre las
+     * ejecuciones (paralelismo anidado). Con bisect_depth > 0 se añaden, en rondas sucesivas, los puntos
+     * medios entre valores consecutivos con distinto nº de comunidades para delimitar las mesetas de
+     * estabilidad (rangos de gamma con la misma partición).
+     * @param graph Grafo CSR de entrada (solo lectura).
+     * @param gammas Valores de gamma iniciales.
+     * @param min_gain Umbral mínimo de ganancia de calidad para aceptar un movimiento.
+     * @param bisect_depth Nº máximo de rondas de bisección (0 = sin bisección).
+     * @param quality Función de calidad a optimizar.
+     * @return Un resultado por valor de gamma ejecutado, ordenados por gamma.
+     */
+    static std::vector<ResolutionResult> sweepResolution(const CompactGraph& graph, const std::vector<double>& gammas,
+                                                         double min_gain = 0, int bisect_depth = 0,
+                                                         QualityType quality = QualityType::CPM);
+
+    /**
+     * @brief Agrupamiento por consenso de varias optimizaciones con orden de nodos aleatorio.
+     * @details Lanza n_runs ejecuciones independientes de movimiento local CPM (runRandomOrder()), cada una
+     * con su propia semilla y su propio orden aleatorio de nodos, repartidas entre los hilos; el grafo solo se
+     * lee. Después construye el grafo de consenso en forma dispersa: solo se consideran las aristas existentes
+     * y se conservan, con su peso, aquellas cuyos extremos coinciden en al menos una fracción 'threshold' de
+     * las ejecuciones. Las ejecuciones se repiten sobre el grafo de consenso (hasta ENSEMBLE_MAX_ROUNDS rondas)
+     * hasta que todas coinciden, y una última pasada sobre el grafo original, partiendo del consenso, recoloca
+     * los nodos que quedaron sueltos. Cada ronda cuesta O(n_runs * m) y la memoria es O(n_runs * n + m).
+     * Si time_budget > 0, las ejecuciones que aún no han empezado cuando se agota el presupuesto se omiten
+     * y el consenso se calcula con las completadas.
+     * @param graph Grafo CSR de entrada (solo lectura).
+     * @param gamma Parámetro de resolución del CPM.
+     * @param n_runs Nº de ejecuciones aleatorias.
+     * @param min_gain Umbral mínimo de ganancia de calidad para aceptar un movimiento.
+     * @param threshold Fracción mínima de coincidencias para conservar una arista en el grafo de consenso.
+     * @param time_budget Presupuesto de tiempo en segundos para las ejecuciones aleatorias (0 = sin límite).
+     * @param seed Semilla base; la ejecución k usa la semilla derivada de (seed, k), por lo que el resultado
+     * es reproducible con independencia del nº de hilos.
+     * @param quality Función de calidad a optimizar.
+     * @return Partición de consenso y estadísticas de las ejecuciones.
+     */
+    static EnsembleResult runEnsemble(const CompactGraph& graph, double gamma, int n_runs, double min_gain = 0,
+                                      double threshold = 0.5, double time_budget = 0.0, unsigned int seed = 1,
+                                      QualityType quality = QualityType::CPM);
+
+    static const int ENSEMBLE_MAX_ROUNDS = 8; ///< Cota de rondas de consenso en runEnsemble().
+
+    /**
+     * @brief Ejecuta la optimización local CPM de forma asíncrona, sin barreras entre barridos.
+     * @details Trabaja sobre una instantánea CSR de la red (como runCompact()) y al terminar escribe la
+     * comunidad final en la partición. Ver la versión estática para los detalles del motor.
+     * @param min_gain Umbral mínimo de ganancia de calidad para aceptar un movimiento.
+     * @param gamma Parámetro de resolución del CPM.
      */
-    void run(double min_gain = 0, double gamma = 1.0);
+    void runAsync(double min_gain = 0, double gamma = 1.0, QualityType quality = QualityType::CPM);
+
+    /**
+     * @brief Movimiento local CPM asíncrono y sin bloqueos sobre una instantánea CSR.
+     * @details Los hilos extraen nodos de una cola compartida (AsyncNodeQueue), leen las etiquetas de los
+     * vecinos con accesos atómicos relajados y aplican cada movimiento al momento con actualizaciones
+     * atómicas de la etiqueta y de los contadores de tamaño y grado de las comunidades. Un nodo que se
+     * mueve encola a sus vecinos de otras comunidades. No hay barreras ni barridos: el algoritmo converge
+     * cuando la cola queda vacía y ningún hilo está evaluando un nodo (quiescencia). Como las decisiones
+     * pueden basarse en datos ligeramente desfasados, el resultado puede variar entre ejecuciones.
+     * @param graph Grafo CSR de entrada (solo lectura).
+     * @param min_gain Umbral mínimo de ganancia de calidad para aceptar un movimiento.
+     * @param gamma Parámetro de resolución del CPM.
+     * @param verbose Si es true, imprime el tiempo, las evaluaciones y los movimientos.
+     * @param quality Función de calidad a optimizar.
+     * @return Comunidad de cada nodo, indexada por índice denso (el ID de comunidad es el índice de uno de sus nodos).
+     */
+    static std::vector<int> runAsync(const CompactGraph& graph, double min_gain = 0, double gamma = 1.0,
+                                     bool verbose = true, QualityType quality = QualityType::CPM);
+
+    static const int ASYNC_MAX_MOVES_PER_NODE = 64; ///< Cota de movimientos por nodo en runAsync() (evita oscilaciones).
 
 
         /**
      * @brief Fusiona los nodos que pertenecen a la misma comunidad en nodos únicos.
-     * @details Implementa el pseudocódigo mergeCommunities(G):
-     *  - Agrupa los nodos por su atributo community.
-     *  - Para cada comunidad con tamaño > 1, crea un nodo nuevo que representa a dicha comunidad.
-     *  - Acumula los pesos de las aristas hacia nodos fuera de la comunidad (externalWeights).
-     *  - Crea aristas desde el nodo fusionado hacia cada vecino externo con el peso total acumulado.
-     *  - Elimina los nodos originales de esa comunidad.
-     * 
-     * Complejidad: O(m), siendo m el número de aristas de la red.
+     * @details Implementa el pseudocódigo mergeCommunities(G) como una agregación en paralelo:
+     *  - Agrupa los nodos por su comunidad en la partición.
+     *  - Crea un nodo nuevo que representa a cada comunidad (con su nº de nodos originales como tamaño).
+     *  - Convierte cada arista en una tripleta (comunidad_u, comunidad_v, peso) en paralelo.
+     *  - Reduce las tripletas por pares de comunidades (ordenación por conteo y suma por vecino en paralelo)
+     *    y crea una arista por par con el peso total acumulado.
+     *  - Conserva el peso de las aristas internas como un bucle (self-loop) del nodo fusionado.
+     *  - Sustituye la red por la red agregada y reinicia la partición (cada supernodo en su comunidad).
+     *  - Registra la agregación como un nivel del dendrograma de la red, si se ha indicado (setDendrogram()).
+     *
+     * Es la única operación que modifica la red; runMultilevel() agrega sobre copias propias.
+     * Complejidad: O(n + m), siendo n y m el número de nodos y aristas de la red.
      */
     void mergeCommunities();
 
+    /**
+     * @brief Ejecuta el algoritmo multinivel completo (estilo Louvain) hasta converger.
+     * @details Alterna run() y la agregación de comunidades automáticamente. La red de entrada no se modifica:
+     * cada nivel se agrega en una red propia (buildCoarseNetwork()) y al final la partición del algoritmo
+     * contiene la comunidad de cada nodo de la red de entrada. Cada supernodo conserva como bucle el
+     * peso interno de su comunidad y aporta su nº de nodos originales como tamaño en el CPM, por lo que todos los
+     * niveles optimizan la misma función de calidad sobre la red original. Se detiene cuando un nivel no
+     * fusiona ningún nodo (o al alcanzar max_levels).
+     *
+     * Con refine = true se añade la fase de refinamiento de Leiden (refineCommunities()) entre el movimiento
+     * local y la agregación: se agregan las subcomunidades refinadas y el siguiente nivel parte de la
+     * partición no refinada, lo que garantiza comunidades bien conectadas.
+     *
+     * Las agregaciones de los niveles se guardan como un Dendrogram (getDendrogram()) en lugar de copiar
+     * listas de miembros, y la partición final se extiende en paralelo a los nodos de la red de entrada.
+     * Con setCheckpoint() se guardan puntos de control entre las etapas y se puede reanudar desde ellos.
+     * @param gamma Parámetro de resolución del CPM.
+     * @param min_gain Umbral mínimo de ganancia de calidad para aceptar un movimiento.
+     * @param mode Estrategia de aplicación de movimientos en cada nivel.
+     * @param max_levels Nº máximo de niveles (0 = sin límite).
+     * @param refine Activa la fase de refinamiento de Leiden.
+     * @param quality Función de calidad a optimizar en todos los niveles.
+     * @return Comunidad final de cada nodo original, indexada por su ID (-1 para IDs sin nodo). Si la red es
+     * el resultado de agregaciones registradas con setDendrogram(), se extiende a los nodos originales.
+     */
+    std::vector<int> runMultilevel(double gamma = 1.0, double min_gain = 0, MoveMode mode = MoveMode::BATCH,
+                                   int max_levels = 0, bool refine = false, QualityType quality = QualityType::CPM);
+
+    /**
+     * @brief Tiempo ocupado/inactivo y bloques procesados por cada hilo en la última llamada a run().
+     */
+    const std::vector<WorkScheduler::ThreadStats>& getThreadStats() const { return thread_stats; }
+
+    /**
+     * @brief Activa las métricas de ejecución (nullptr las desactiva, que es lo predeterminado).
+     * @details run() registra barridos, nodos y ΔQ evaluados, movimientos propuestos, aplicados y
+     * descartados, la calidad tras cada barrido, el tiempo de preparación, de la región paralela y de
+     * aplicación, y la carga de cada hilo; mergeCommunities() y runMultilevel() el tiempo de agregación y los
+     * nodos fusionados. runMultilevel() pasa el mismo objeto a todos sus niveles.
+     * @param t Destino de las métricas; debe existir mientras se use el algoritmo.
+     */
+    void setTelemetry(Telemetry* t) { telemetry = t; }
+
+    /**
+     * @brief Activa los mensajes por consola (desactivados por defecto).
+     * @details run(), runCompact(), runAsync() y runMultilevel() imprimen entonces el tiempo, los
+     * movimientos, el reparto de carga entre hilos y el resumen de cada nivel. Sin ellos, los mismos datos
+     * solo se obtienen con setTelemetry().
+     */
+    void setVerbose(bool v) { verbose = v; }
+
+    /**
+     * @brief Indica el dendrograma con las agregaciones ya aplicadas a la red (nullptr si no se guardan).
+     * @details mergeCommunities() le añade un nivel y runMultilevel() lo usa para devolver la comunidad de
+     * los nodos originales. Debe contener exactamente las agregaciones que han llevado a la red actual.
+     * @param d Dendrogram de la red; debe existir mientras se use el algoritmo.
+     */
+    void setDendrogram(Dendrogram* d) { dendrogram = d; }
+
+    /**
+     * @brief Agregaciones de la última llamada a runMultilevel(); el nivel 0 son los nodos de su red de entrada.
+     */
+    const Dendrogram& getDendrogram() const { return hierarchy; }
+
+    /**
+     * @brief Activa los puntos de control de runMultilevel() (fichero vacío los desactiva).
+     * @details Tras cada movimiento local (run()) y tras cada agregación runMultilevel() guarda en el fichero
+     * la red del nivel, la partición, el dendrograma y el nivel alcanzado. La escritura se hace en segundo
+     * plano (CheckpointWriter) y sustituye al punto de control anterior solo cuando está completa.
+     * @param filename Fichero del punto de control.
+     * @param interval Segundos mínimos entre dos puntos de control (0 = en todas las etapas).
+     * @param resume Si es true y el fichero contiene un punto de control de la misma red y parámetros,
+     * runMultilevel() continúa desde él en lugar de empezar desde el principio.
+     */
+    void setCheckpoint(const std::string& filename, double interval = 0.0, bool resume = false) {
+        checkpoint_file = filename;
+        checkpoint_interval = interval;
+        checkpoint_resume = resume;
+    }
+
 private:
     networkStructure::Network* network; ///< Puntero a la red que se está procesando.
+    std::unique_ptr<Partition> owned_partition; ///< Partición propia (si no se pasa una externa).
+    Partition* partition;                       ///< Partición en uso (propia o externa).
+    std::vector<WorkScheduler::ThreadStats> thread_stats; ///< Reparto de carga de la última llamada a run().
+    Telemetry* telemetry = nullptr;             ///< Métricas de ejecución (opcional).
+    bool verbose = false;                       ///< Mensajes por consola (ver setVerbose()).
+    Dendrogram* dendrogram = nullptr;           ///< Agregaciones aplicadas a la red (ver setDendrogram()).
+    Dendrogram hierarchy;                       ///< Niveles de la última llamada a runMultilevel().
+    std::string checkpoint_file;                ///< Fichero de los puntos de control (vacío = sin ellos).
+    double checkpoint_interval = 0.0;           ///< Segundos mínimos entre dos puntos de control.
+    bool checkpoint_resume = false;             ///< Continuar desde el punto de control existente.
     /**
      * @brief Asigna a cada nodo su propia comunidad única.
-     * @details Sobrescribe la inicialización por defecto de la clase Node (que asigna 1).
-     * Cada nodo 'i' se asigna a la comunidad 'i'.
+     * @details Cada nodo 'i' se asigna a la comunidad 'i' en la partición.
      */
     void initializeCommunities();
 
+    /**
+     * @brief Construye la red agregada de la partición actual sin modificar la red original.
+     * @details Cada comunidad pasa a ser un nodo (IDs densos 0..k-1 en orden de primera aparición) cuyo
+     * tamaño es la suma de los tamaños de los nodos de la comunidad. Las aristas entre dos comunidades se suman en una
+     * sola arista y el peso interno de cada comunidad se conserva como un bucle. Complejidad O(n + m).
+     * Las aristas se reparten por bloques entre los hilos, que emiten tripletas (supernodo menor, supernodo
+     * mayor, peso) en la partición (rango contiguo de supernodos) del menor; cada partición se ordena por
+     * conteo y se reduce con un NeighborAccumulator, y la red agregada se construye después de una vez con
+     * los grados ya conocidos. La red resultante no depende del nº de hilos.
+     * @param coarse_of Salida: ID del nodo agregado de cada ID de nodo de la red (-1 si el ID no tiene nodo).
+     * @return La red agregada.
+     */
+    std::unique_ptr<Network> buildCoarseNetwork(std::vector<int>& coarse_of);
+
+    /**
+     * @brief Versiones especializadas de run(), runCompact(), runAsync(), runEnsemble(), evaluateQuality() y
+     * refineCommunities() para una función de calidad fijada en tiempo de compilación (CPMQuality,
+     * ModularityQuality o RBERQuality). Los parámetros son los del método público correspondiente.
+     */
+    template <class Quality>
+    void runKernel(double min_gain, double gamma, MoveMode mode, bool reset_communities);
+    template <class Quality>
+    static std::vector<int> compactKernel(const CompactGraph& graph, double min_gain, double gamma, bool verbose);
+    template <class Quality>
+    static std::vector<int> asyncKernel(const CompactGraph& graph, double min_gain, double gamma, bool verbose);
+    template <class Quality>
+    static EnsembleResult ensembleKernel(const CompactGraph& graph, double gamma, int n_runs, double min_gain,
+                                         double threshold, double time_budget, unsigned int seed);
+    template <class Quality>
+    static double qualityKernel(const CompactGraph& graph, const std::vector<int>& community, double gamma);
+    template <class Quality>
+    std::unordered_map<int, int> refineKernel(double gamma);
+
+    /**
+     * @brief Movimiento local secuencial sobre un grafo CSR, recorriendo los nodos en orden aleatorio.
+     * @details Los nodos se visitan desde una cola inicializada con una permutación aleatoria; cuando un nodo
+     * cambia de comunidad se encolan sus vecinos de otras comunidades. Es la ejecución individual de
+     * runEnsemble(), que reparte varias de ellas entre los hilos.
+     * @param graph Grafo CSR de entrada (solo lectura).
+     * @param min_gain Umbral mínimo de ganancia de calidad para aceptar un movimiento.
+     * @param gamma Parámetro de resolución del CPM.
+     * @param rng Generador con el que se baraja el orden de los nodos.
+     * @param initial Partición inicial (índices densos en [0, n)), o nullptr para empezar con un nodo por comunidad.
+     * @return Comunidad de cada nodo, indexada por índice denso.
+     */
+    template <class Quality>
+    static std::vector<int> runRandomOrder(const CompactGraph& graph, double min_gain, double gamma, std::mt19937& rng,
+                                           const std::vector<int>* initial = nullptr);
+
     /**
      * @brief Obtiene los pesos de las aristas de un nodo hacia cada comunidad vecina.
+     * @details Vacía el acumulador y suma en él, por cada comunidad vecina, el peso de las aristas hacia
+     * ella (k_i_in). No reserva memoria: el acumulador se reutiliza entre nodos e iteraciones.
      * @param node El nodo a inspeccionar.
-     * @return Un mapa donde la clave es el ID de la comunidad vecina y el valor es la suma de pesos de las aristas a esa comunidad (k_i_in).
+     * @param weights Acumulador del hilo, con capacidad para todos los IDs de comunidad.
+     */
+    void getNeighborCommunityWeights(networkStructure::Node* node, NeighborAccumulator& weights);
+
+    /**
+     * @brief Fase de refinamiento de Leiden: divide cada comunidad en subcomunidades bien conectadas.
+     * @details Dentro de cada comunidad C, todos los nodos empiezan solos en su subcomunidad. Cada nodo que
+     * sigue solo y está bien conectado con C (E(v, C-v) >= gamma * n_v * (|C| - n_v) en el CPM; en general,
+     * el peso esperado entre v y C-v según la función de calidad) se une a la subcomunidad T de C, también
+     * bien conectada, con mayor ganancia E(v, T) - gamma * n_v * |T| >= 0.
+     * La elección es voraz (determinista) en lugar de aleatoria. Las comunidades se refinan en paralelo con
+     * OpenMP, ya que son independientes. Al terminar, la comunidad de cada nodo en la partición es su
+     * subcomunidad refinada.
+     * @param gamma Parámetro de resolución del CPM.
+     * @param quality Función de calidad.
+     * @return Mapa ID de subcomunidad refinada -> ID de la comunidad no refinada que la contiene.
      */
-    std::map<int, double> getNeighborCommunityWeights(networkStructure::Node* node);
+    std::unordered_map<int, int> refineCommunities(double gamma, QualityType quality = QualityType::CPM);
 };
 
 } // namespace networkStructure
@@ -0,0 +1,93 @@
+#include "AsyncNodeQueue.h"
+#include <atomic>
+
+namespace networkStructure {
+
+AsyncNodeQueue::AsyncNodeQueue(std::size_t n_nodes) {
+    std::size_t capacity = 1;
+    while (capacity < n_nodes) capacity <<= 1;
+    mask = capacity - 1;
+    cells.reset(new Cell[capacity]);
+    for (std::size_t i = 0; i < capacity; ++i) {
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+        cells[i].node = -1;
+    }
+    states.reset(new std::atomic<char>[n_nodes]);
+    for (std::size_t i = 0; i < n_nodes; ++i) {
+        states[i].store(IDLE, std::memory_order_relaxed);
+    }
+}
+
+void AsyncNodeQueue::enqueue(int node) {
+    // Nunca se llena: cada nodo ocupa como mucho una celda y la capacidad es >= nº de nodos
+    std::size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true) {
+        cell = &cells[pos & mask];
+        std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+        std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+        if (diff == 0) {
+            if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else {
+            pos = enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+    cell->node = node;
+    cell->sequence.store(pos + 1, std::memory_order_release);
+}
+
+void AsyncNodeQueue::push(int node) {
+    // Barrera completa: la nueva etiqueta del nodo que se movió queda visible antes de leer el estado del
+    // vecino. Junto con la de pop() garantiza que, si aquí se ve QUEUED, quien lo evalúe verá la etiqueta.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::atomic<char>& state = states[node];
+    char s = state.load(std::memory_order_relaxed);
+    while (true) {
+        if (s == IDLE) {
+            if (state.compare_exchange_weak(s, QUEUED, std::memory_order_acq_rel)) {
+                pending.fetch_add(1, std::memory_order_acq_rel);
+                enqueue(node);
+                return;
+            }
+        } else if (s == PROCESSING) {
+            if (state.compare_exchange_weak(s, DIRTY, std::memory_order_acq_rel)) return;
+        } else {
+            return; // QUEUED o DIRTY: ya se evaluará
+        }
+    }
+}
+
+bool AsyncNodeQueue::pop(int& node) {
+    std::size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true) {
+        cell = &cells[pos & mask];
+        std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+        std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+        if (diff == 0) {
+            if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            return false; // cola vacía
+        } else {
+            pos = dequeue_pos.load(std::memory_order_relaxed);
+        }
+    }
+    node = cell->node;
+    cell->sequence.store(pos + mask + 1, std::memory_order_release);
+    states[node].store(PROCESSING, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst); // ver push()
+    return true;
+}
+
+void AsyncNodeQueue::finish(int node) {
+    char expected = PROCESSING;
+    if (states[node].compare_exchange_strong(expected, IDLE, std::memory_order_acq_rel)) {
+        pending.fetch_sub(1, std::memory_order_acq_rel);
+        return;
+    }
+    // DIRTY: vuelve a la cola y sigue contando como pendiente
+    states[node].store(QUEUED, std::memory_order_release);
+    enqueue(node);
+}
+
+} // namespace networkStructure
@@ -0,0 +1,79 @@
+#ifndef ASYNCNODEQUEUE_H
+#define ASYNCNODEQUEUE_H
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <cstddef>
+
+namespace networkStructure {
+
+/**
+ * @class AsyncNodeQueue
+ * @brief Cola compartida y sin bloqueos de nodos pendientes de evaluar, para el movimiento local asíncrono.
+ * @details Es una cola MPMC acotada (algoritmo de Vyukov: cada celda lleva un nº de secuencia atómico) con
+ * un estado por nodo que garantiza que cada nodo está como mucho una vez en la cola y que nunca lo
+ * evalúan dos hilos a la vez:
+ *  - IDLE: ni en la cola ni en evaluación.
+ *  - QUEUED: en la cola.
+ *  - PROCESSING: un hilo lo está evaluando.
+ *  - DIRTY: un vecino cambió de comunidad durante la evaluación; al terminar vuelve a la cola.
+ *
+ * El contador 'pending' cuenta los nodos en la cola o en evaluación. Un nodo encola a sus vecinos antes
+ * de dejar de contar, así que pending == 0 significa que no queda trabajo ni puede aparecer (quiescencia).
+ */
+class AsyncNodeQueue {
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        int node;
+    };
+
+    enum State : char { IDLE = 0, QUEUED = 1, PROCESSING = 2, DIRTY = 3 };
+
+    std::unique_ptr<Cell[]> cells;                       ///< Búfer circular.
+    std::size_t mask = 0;                                ///< Capacidad - 1 (la capacidad es potencia de 2).
+    std::unique_ptr<std::atomic<char>[]> states;         ///< Estado de cada nodo.
+    alignas(64) std::atomic<std::size_t> enqueue_pos{0}; ///< Siguiente posición de escritura.
+    alignas(64) std::atomic<std::size_t> dequeue_pos{0}; ///< Siguiente posición de lectura.
+    alignas(64) std::atomic<long> pending{0};            ///< Nodos en la cola o en evaluación.
+
+    void enqueue(int node);
+
+public:
+    /**
+     * @brief Crea una cola vacía para nodos en [0, n_nodes).
+     */
+    explicit AsyncNodeQueue(std::size_t n_nodes);
+
+    AsyncNodeQueue(const AsyncNodeQueue&) = delete;
+    AsyncNodeQueue& operator=(const AsyncNodeQueue&) = delete;
+
+    /**
+     * @brief Marca un nodo para ser evaluado (de nuevo).
+     * @details Si está inactivo se encola; si se está evaluando se marca para volver a la cola al terminar;
+     * si ya está en la cola no hace nada.
+     */
+    void push(int node);
+
+    /**
+     * @brief Extrae un nodo de la cola y lo marca como en evaluación.
+     * @return false si la cola está vacía en ese momento (puede que otros hilos aún añadan nodos).
+     */
+    bool pop(int& node);
+
+    /**
+     * @brief Termina la evaluación de un nodo extraído con pop().
+     * @details Debe llamarse después de encolar a los vecinos afectados por su movimiento.
+     */
+    void finish(int node);
+
+    /**
+     * @brief Indica si no queda ningún nodo en la cola ni en evaluación (convergencia).
+     */
+    bool isQuiescent() const { return pending.load(std::memory_order_acquire) == 0; }
+};
+
+} // namespace networkStructure
+
+#endif // ASYNCNODEQUEUE_H
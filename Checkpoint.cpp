@@ -0,0 +1,290 @@
+#include "Checkpoint.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <utility>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <omp.h>
+
+namespace networkStructure {
+
+namespace {
+static_assert(sizeof(int) == sizeof(std::int32_t), "Las etiquetas del formato son de 32 bits");
+
+const char CHECKPOINT_MAGIC[8] = {'C', 'D', 'C', 'K', 'P', 'T', '\0', '\0'};
+const std::uint32_t CHECKPOINT_VERSION = 1;
+
+// Cabecera del fichero (80 bytes)
+struct CheckpointHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t stage;
+    std::uint32_t level;
+    std::uint32_t quality;
+    std::uint32_t mode;
+    std::uint32_t refine;
+    std::int32_t max_levels;
+    std::uint32_t has_network;
+    double gamma;
+    double min_gain;
+    std::uint64_t input_bound;
+    std::uint64_t input_nodes;
+    std::uint64_t n_levels;
+};
+static_assert(sizeof(CheckpointHeader) == 80, "La cabecera del punto de control ocupa 80 bytes en el fichero");
+
+// Nodo y arista de la red del nivel
+struct NodeRecord {
+    std::uint32_t id;
+    std::uint32_t size;
+};
+struct EdgeEntry {
+    std::uint32_t origin;
+    std::uint32_t destiny;
+    double weight;
+};
+
+void append(std::vector<char>& buffer, const void* data, std::size_t bytes) {
+    const char* p = static_cast<const char*>(data);
+    buffer.insert(buffer.end(), p, p + bytes);
+}
+
+void appendCount(std::vector<char>& buffer, std::uint64_t count) {
+    append(buffer, &count, sizeof(count));
+}
+
+// Lectura secuencial del fichero con comprobación de límites
+class Reader {
+public:
+    explicit Reader(const std::vector<char>& data) : data(data) {}
+    bool read(void* out, std::size_t bytes) {
+        if (bytes > data.size() - pos) return false;
+        std::memcpy(out, data.data() + pos, bytes);
+        pos += bytes;
+        return true;
+    }
+    bool readCount(std::uint64_t& count, std::size_t element_size) {
+        // El nº de elementos no puede superar lo que queda de fichero
+        return read(&count, sizeof(count)) && count <= (data.size() - pos) / element_size;
+    }
+
+private:
+    const std::vector<char>& data;
+    std::size_t pos = 0;
+};
+
+// Escribe el fichero completo y lo sincroniza con el disco
+bool writeFile(const std::string& filename, const std::vector<char>& buffer) {
+    int fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+    std::size_t done = 0;
+    while (done < buffer.size()) {
+        ssize_t n = ::write(fd, buffer.data() + done, buffer.size() - done);
+        if (n <= 0) {
+            ::close(fd);
+            return false;
+        }
+        done += static_cast<std::size_t>(n);
+    }
+    bool synced = ::fsync(fd) == 0;
+    return ::close(fd) == 0 && synced;
+}
+} // namespace
+
+bool CheckpointInfo::sameRun(const CheckpointInfo& other) const {
+    return quality == other.quality && mode == other.mode && refine == other.refine &&
+           max_levels == other.max_levels && gamma == other.gamma && min_gain == other.min_gain &&
+           input_bound == other.input_bound && input_nodes == other.input_nodes;
+}
+
+std::vector<char> serializeCheckpoint(const CheckpointInfo& info, const Dendrogram& hierarchy, Network* level_network,
+                                      const Network& labels_network, const Partition& partition) {
+    CheckpointHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+    header.version = CHECKPOINT_VERSION;
+    header.stage = static_cast<std::uint32_t>(info.stage);
+    header.level = info.level;
+    header.quality = info.quality;
+    header.mode = info.mode;
+    header.refine = info.refine;
+    header.max_levels = info.max_levels;
+    header.has_network = level_network ? 1u : 0u;
+    header.gamma = info.gamma;
+    header.min_gain = info.min_gain;
+    header.input_bound = info.input_bound;
+    header.input_nodes = info.input_nodes;
+    header.n_levels = hierarchy.getNLevels();
+
+    std::vector<char> buffer;
+    append(buffer, &header, sizeof(header));
+
+    // Dendrograma: vector de padres de cada nivel
+    for (std::size_t l = 0; l < hierarchy.getNLevels(); ++l) {
+        const std::vector<int>& parents = hierarchy.getParents(l);
+        appendCount(buffer, parents.size());
+        append(buffer, parents.data(), parents.size() * sizeof(std::int32_t));
+    }
+
+    // Red del nivel: nodos (ID y tamaño) y aristas en orden de ID, para reconstruirla igual
+    if (level_network) {
+        std::vector<NodeRecord> node_records;
+        node_records.reserve(level_network->getNNodes());
+        for (const auto& ptr : level_network->getNodes()) {
+            if (ptr) node_records.push_back(NodeRecord{ptr->getID(), ptr->getSize()});
+        }
+        std::vector<EdgeEntry> edge_entries;
+        edge_entries.reserve(level_network->getNEdges());
+        for (const auto& ptr : level_network->getEdges()) {
+            if (ptr) edge_entries.push_back(EdgeEntry{ptr->getOrigin()->getID(), ptr->getDestiny()->getID(), ptr->getWeight()});
+        }
+        appendCount(buffer, level_network->getIdBound());
+        appendCount(buffer, node_records.size());
+        append(buffer, node_records.data(), node_records.size() * sizeof(NodeRecord));
+        appendCount(buffer, edge_entries.size());
+        append(buffer, edge_entries.data(), edge_entries.size() * sizeof(EdgeEntry));
+    }
+
+    // Partición del nivel
+    std::vector<std::int32_t> labels(labels_network.getIdBound(), -1);
+    for (const auto& ptr : labels_network.getNodes()) {
+        if (ptr) labels[ptr->getID()] = partition.getCommunity(ptr->getID());
+    }
+    appendCount(buffer, labels.size());
+    append(buffer, labels.data(), labels.size() * sizeof(std::int32_t));
+    return buffer;
+}
+
+bool loadCheckpoint(const std::string& filename, CheckpointInfo& info, Dendrogram& hierarchy,
+                    std::unique_ptr<Network>& level_network, std::vector<int>& labels) {
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open()) {
+        return false; // No hay punto de control
+    }
+    std::vector<char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    Reader reader(data);
+
+    CheckpointHeader header;
+    if (!reader.read(&header, sizeof(header)) || std::memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != CHECKPOINT_VERSION) {
+        std::cerr << "Error: " << filename << " no es un punto de control valido (version " << CHECKPOINT_VERSION << ")." << std::endl;
+        return false;
+    }
+    info.stage = header.stage == 1u ? CheckpointStage::AFTER_RUN : CheckpointStage::LEVEL_START;
+    info.level = header.level;
+    info.quality = header.quality;
+    info.mode = header.mode;
+    info.refine = header.refine;
+    info.max_levels = header.max_levels;
+    info.gamma = header.gamma;
+    info.min_gain = header.min_gain;
+    info.input_bound = header.input_bound;
+    info.input_nodes = header.input_nodes;
+
+    bool valid = true;
+    Dendrogram loaded;
+    for (std::uint64_t l = 0; l < header.n_levels && valid; ++l) {
+        std::uint64_t n = 0;
+        valid = reader.readCount(n, sizeof(std::int32_t));
+        if (!valid) break;
+        std::vector<int> parents(n);
+        valid = reader.read(parents.data(), n * sizeof(std::int32_t));
+        if (valid) loaded.addLevel(std::move(parents));
+    }
+
+    std::unique_ptr<Network> network;
+    if (valid && header.has_network) {
+        std::uint64_t id_bound = 0, n_nodes = 0, n_edges = 0;
+        valid = reader.read(&id_bound, sizeof(id_bound)) && reader.readCount(n_nodes, sizeof(NodeRecord));
+        std::vector<NodeRecord> node_records(valid ? n_nodes : 0);
+        valid = valid && reader.read(node_records.data(), node_records.size() * sizeof(NodeRecord)) &&
+                reader.readCount(n_edges, sizeof(EdgeEntry));
+        std::vector<EdgeEntry> edge_entries(valid ? n_edges : 0);
+        valid = valid && reader.read(edge_entries.data(), edge_entries.size() * sizeof(EdgeEntry));
+        // El rango de IDs se comprueba antes de reservarlo: las redes guardadas son agregadas
+        // (buildCoarseNetwork()) y por tanto densas, con IDs de 32 bits y como mucho tantos nodos como la
+        // red de entrada
+        valid = valid && id_bound == n_nodes && id_bound <= header.input_bound &&
+                id_bound <= static_cast<std::uint64_t>(std::numeric_limits<unsigned int>::max()) + 1;
+        for (const NodeRecord& r : node_records) {
+            valid = valid && r.id < id_bound;
+        }
+        if (valid) {
+            network.reset(new Network());
+            network->reserve(id_bound, edge_entries.size());
+            for (const NodeRecord& r : node_records) {
+                network->addNode(r.id)->setSize(r.size);
+            }
+            for (const EdgeEntry& e : edge_entries) {
+                // Las aristas solo pueden unir nodos guardados
+                valid = valid && network->getNode(e.origin) && network->getNode(e.destiny);
+                if (valid) network->addEdge(e.origin, e.destiny, e.weight);
+            }
+        }
+    }
+
+    std::uint64_t n_labels = 0;
+    valid = valid && reader.readCount(n_labels, sizeof(std::int32_t));
+    std::vector<int> loaded_labels(valid ? n_labels : 0);
+    valid = valid && reader.read(loaded_labels.data(), loaded_labels.size() * sizeof(std::int32_t));
+    if (!valid) {
+        std::cerr << "Error: " << filename << " esta truncado o danado." << std::endl;
+        return false;
+    }
+    // Cada padre debe ser un nodo del nivel siguiente (-1 = sin nodo); los del último nivel, nodos de la
+    // red cuyas etiquetas se han guardado
+    for (std::size_t l = 0; l < loaded.getNLevels() && valid; ++l) {
+        std::size_t next_size = (l + 1 < loaded.getNLevels()) ? loaded.getParents(l + 1).size() : loaded_labels.size();
+        for (int parent : loaded.getParents(l)) {
+            valid = valid && parent >= -1 && parent < static_cast<long long>(next_size);
+        }
+    }
+    if (!valid) {
+        std::cerr << "Error: El dendrograma de " << filename << " no es valido." << std::endl;
+        return false;
+    }
+    hierarchy = std::move(loaded);
+    level_network = std::move(network);
+    labels = std::move(loaded_labels);
+    return true;
+}
+
+CheckpointWriter::CheckpointWriter(const std::string& filename, double interval)
+    : filename(filename), interval(interval), last_submit(0.0), ok(true) {
+}
+
+CheckpointWriter::~CheckpointWriter() {
+    wait();
+}
+
+bool CheckpointWriter::due() const {
+    return written == 0 || omp_get_wtime() - last_submit >= interval;
+}
+
+void CheckpointWriter::submit(std::vector<char> buffer) {
+    wait();
+    last_submit = omp_get_wtime();
+    ++written;
+    // El hilo escribe en un fichero temporal y lo renombra: el punto de control anterior sigue siendo
+    // válido hasta que el nuevo está completo en el disco
+    worker = std::thread([this, data = std::move(buffer)]() {
+        std::string tmp = filename + ".tmp";
+        bool done = writeFile(tmp, data) && std::rename(tmp.c_str(), filename.c_str()) == 0;
+        if (!done) {
+            std::cerr << "Error: No se pudo escribir el punto de control " << filename << std::endl;
+            ok.store(false);
+        }
+    });
+}
+
+bool CheckpointWriter::wait() {
+    if (worker.joinable()) worker.join();
+    return ok.load();
+}
+
+} // namespace networkStructure
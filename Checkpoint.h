@@ -0,0 +1,130 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "Network.h"
+#include "Partition.h"
+#include "Dendrogram.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace networkStructure {
+
+/**
+ * @enum CheckpointStage
+ * @brief Punto de runMultilevel() en el que se guarda un punto de control.
+ */
+enum class CheckpointStage : std::uint32_t {
+    LEVEL_START = 0, ///< Tras agregar: red del nivel y partición de partida de su movimiento local.
+    AFTER_RUN = 1    ///< Tras el movimiento local (run()) del nivel, antes de refinar y agregar.
+};
+
+/**
+ * @struct CheckpointInfo
+ * @brief Estado del optimizador y parámetros de la ejecución guardados en un punto de control.
+ * @details Los parámetros y el tamaño de la red de entrada sirven para comprobar, al reanudar, que el
+ * punto de control corresponde a la misma ejecución.
+ */
+struct CheckpointInfo {
+    CheckpointStage stage = CheckpointStage::LEVEL_START; ///< Etapa guardada.
+    std::uint32_t level = 0;          ///< Movimientos locales completados (niveles) al guardar.
+    std::uint32_t quality = 0;        ///< Función de calidad (valor de QualityType).
+    std::uint32_t mode = 0;           ///< Estrategia de aplicación de movimientos (valor de MoveMode).
+    std::uint32_t refine = 0;         ///< 1 si se usa el refinamiento de Leiden.
+    std::int32_t max_levels = 0;      ///< Nº máximo de niveles (0 = sin límite).
+    double gamma = 0.0;               ///< Parámetro de resolución.
+    double min_gain = 0.0;            ///< Umbral mínimo de ganancia.
+    std::uint64_t input_bound = 0;    ///< getIdBound() de la red de entrada.
+    std::uint64_t input_nodes = 0;    ///< Nº de nodos de la red de entrada.
+
+    /**
+     * @brief Indica si dos puntos de control son de la misma ejecución (parámetros y red de entrada).
+     */
+    bool sameRun(const CheckpointInfo& other) const;
+};
+
+/**
+ * @brief Serializa un punto de control en memoria, en el formato binario que lee loadCheckpoint().
+ * @details Guarda la cabecera con el estado del optimizador, el dendrograma hasta ahora, la red del nivel
+ * actual como lista compacta de nodos (ID y tamaño) y aristas (extremos y peso) en orden de ID, y la
+ * etiqueta de comunidad de cada nodo. En el nivel 0 la red es la de entrada y no se guarda.
+ * @param info Estado del optimizador y parámetros de la ejecución.
+ * @param hierarchy Agregaciones realizadas hasta ahora.
+ * @param level_network Red del nivel actual, o nullptr si es la red de entrada.
+ * @param labels_network Red sobre la que está definida la partición (la del nivel actual).
+ * @param partition Partición del nivel actual.
+ * @return Contenido del fichero.
+ */
+std::vector<char> serializeCheckpoint(const CheckpointInfo& info, const Dendrogram& hierarchy, Network* level_network,
+                                      const Network& labels_network, const Partition& partition);
+
+/**
+ * @brief Lee un punto de control escrito con CheckpointWriter.
+ * @param filename Nombre del fichero.
+ * @param info Salida: estado del optimizador y parámetros.
+ * @param hierarchy Salida: agregaciones realizadas.
+ * @param level_network Salida: red del nivel guardado (nullptr si es la red de entrada).
+ * @param labels Salida: comunidad de cada ID de nodo de la red del nivel (-1 si el ID no tiene nodo).
+ * @return true si se pudo leer, false si no existe o no es un punto de control válido.
+ */
+bool loadCheckpoint(const std::string& filename, CheckpointInfo& info, Dendrogram& hierarchy,
+                    std::unique_ptr<Network>& level_network, std::vector<int>& labels);
+
+/**
+ * @class CheckpointWriter
+ * @brief Escribe puntos de control en segundo plano sin detener el algoritmo.
+ * @details Cada punto de control se escribe en un hilo propio en "<fichero>.tmp", se sincroniza con el
+ * disco y se renombra sobre el fichero, de modo que una caída a mitad de escritura conserva el anterior.
+ * Solo hay una escritura en curso: enviar otra espera a que termine la anterior.
+ */
+class CheckpointWriter {
+private:
+    std::string filename;      ///< Fichero del punto de control.
+    double interval;           ///< Segundos mínimos entre dos puntos de control (0 = en cada etapa).
+    double last_submit;        ///< Instante del último envío (omp_get_wtime()).
+    std::thread worker;        ///< Escritura en curso.
+    std::atomic<bool> ok;      ///< false si alguna escritura ha fallado.
+    unsigned int written = 0;  ///< Nº de puntos de control enviados.
+
+public:
+    /**
+     * @brief Crea el escritor.
+     * @param filename Fichero del punto de control.
+     * @param interval Segundos mínimos entre dos puntos de control (0 = en todas las etapas).
+     */
+    explicit CheckpointWriter(const std::string& filename, double interval = 0.0);
+    ~CheckpointWriter();
+
+    CheckpointWriter(const CheckpointWriter&) = delete;
+    CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+
+    /**
+     * @brief Indica si ha pasado el intervalo desde el último punto de control (siempre cierto el primero).
+     */
+    bool due() const;
+
+    /**
+     * @brief Escribe un punto de control en segundo plano (espera antes a la escritura anterior).
+     * @param buffer Contenido serializado con serializeCheckpoint().
+     */
+    void submit(std::vector<char> buffer);
+
+    /**
+     * @brief Espera a que termine la escritura en curso.
+     * @return true si todas las escrituras terminadas hasta ahora fueron correctas.
+     */
+    bool wait();
+
+    /**
+     * @brief Devuelve el nº de puntos de control enviados.
+     */
+    unsigned int getWritten() const { return written; }
+};
+
+} // namespace networkStructure
+
+#endif // CHECKPOINT_H
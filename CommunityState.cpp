@@ -0,0 +1,39 @@
+#include "CommunityState.h"
+
+namespace networkStructure {
+
+CommunityState::CommunityState(std::size_t capacity) {
+    reset(capacity);
+}
+
+void CommunityState::reset(std::size_t capacity) {
+    sizes.assign(capacity, 0);
+    internal_weights.assign(capacity, 0.0);
+    total_degrees.assign(capacity, 0.0);
+    n_communities = 0;
+}
+
+void CommunityState::addNode(int comm, unsigned int node_size, double degree, double k_in, double self_loop) {
+    if (sizes[comm] == 0) ++n_communities;
+    sizes[comm] += node_size;
+    internal_weights[comm] += k_in + self_loop;
+    total_degrees[comm] += degree;
+}
+
+void CommunityState::moveNode(int from, int to, unsigned int node_size, double degree, double k_in_from, double k_in_to, double self_loop) {
+    if (from == to) return;
+
+    // Salida de la comunidad de origen
+    sizes[from] -= node_size;
+    internal_weights[from] -= k_in_from + self_loop;
+    total_degrees[from] -= degree;
+    if (sizes[from] == 0) --n_communities;
+
+    // Entrada en la comunidad de destino
+    if (sizes[to] == 0) ++n_communities;
+    sizes[to] += node_size;
+    internal_weights[to] += k_in_to + self_loop;
+    total_degrees[to] += degree;
+}
+
+} // namespace networkStructure
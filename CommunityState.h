@@ -0,0 +1,101 @@
+#ifndef COMMUNITYSTATE_H
+#define COMMUNITYSTATE_H
+
+#include <vector>
+#include <cstddef>
+
+namespace networkStructure {
+
+/**
+ * @class CommunityState
+ * @brief Agregados densos por comunidad, indexados directamente por el ID de comunidad.
+ * @details Para cada comunidad guarda su tamaño (suma de los tamaños de sus nodos, es decir, el nº de nodos
+ * originales que representa cuando hay supernodos), el peso total de sus aristas internas
+ * (cada arista una vez, incluidos los bucles) y la suma de los grados de sus nodos. Cuando un nodo cambia
+ * de comunidad los agregados se actualizan en O(1) con moveNode(), por lo que no es necesario
+ * reconstruirlos en cada iteración.
+ *
+ * Las lecturas no usan cerrojos: los hilos de la región paralela solo leen, y las escrituras
+ * (moveNode) se realizan en la fase secuencial de aplicación de movimientos.
+ */
+class CommunityState {
+private:
+    std::vector<unsigned int> sizes;       ///< Nº de nodos originales de cada comunidad.
+    std::vector<double> internal_weights;  ///< Peso total de las aristas internas de cada comunidad.
+    std::vector<double> total_degrees;     ///< Suma de los grados ponderados de los nodos de cada comunidad.
+    std::size_t n_communities = 0;         ///< Nº de comunidades no vacías.
+
+public:
+    /**
+     * @brief Crea un estado vacío con capacidad para IDs de comunidad en [0, capacity).
+     * @param capacity Mayor ID de comunidad posible más uno.
+     */
+    explicit CommunityState(std::size_t capacity = 0);
+
+    /**
+     * @brief Vacía el estado y ajusta la capacidad de IDs de comunidad.
+     * @param capacity Mayor ID de comunidad posible más uno.
+     */
+    void reset(std::size_t capacity);
+
+    /**
+     * @brief Añade un nodo a una comunidad.
+     * @param comm ID de la comunidad.
+     * @param node_size Tamaño del nodo (1, o nº de miembros si es un supernodo).
+     * @param degree Grado ponderado del nodo.
+     * @param k_in Peso de las aristas del nodo hacia otros nodos de la comunidad (sin bucles).
+     * @param self_loop Peso de los bucles del nodo.
+     */
+    void addNode(int comm, unsigned int node_size, double degree, double k_in, double self_loop);
+
+    /**
+     * @brief Mueve un nodo de la comunidad 'from' a la comunidad 'to' en O(1).
+     * @param from Comunidad de origen.
+     * @param to Comunidad de destino.
+     * @param node_size Tamaño del nodo.
+     * @param degree Grado ponderado del nodo.
+     * @param k_in_from Peso de las aristas del nodo hacia el resto de 'from' (sin bucles).
+     * @param k_in_to Peso de las aristas del nodo hacia 'to' (sin bucles).
+     * @param self_loop Peso de los bucles del nodo.
+     */
+    void moveNode(int from, int to, unsigned int node_size, double degree, double k_in_from, double k_in_to, double self_loop);
+
+    /**
+     * @brief Devuelve el tamaño de la comunidad (nº de nodos originales).
+     */
+    unsigned int getSize(int comm) const { return sizes[comm]; }
+
+    /**
+     * @brief Devuelve el peso total de las aristas internas de la comunidad.
+     */
+    double getInternalWeight(int comm) const { return internal_weights[comm]; }
+
+    /**
+     * @brief Devuelve la suma de los grados de los nodos de la comunidad.
+     */
+    double getTotalDegree(int comm) const { return total_degrees[comm]; }
+
+    /**
+     * @brief Devuelve los tamaños de todas las comunidades, indexados por ID (ver bestNeighbor()).
+     */
+    const unsigned int* getSizes() const { return sizes.data(); }
+
+    /**
+     * @brief Devuelve los grados totales de todas las comunidades, indexados por ID.
+     */
+    const double* getTotalDegrees() const { return total_degrees.data(); }
+
+    /**
+     * @brief Devuelve el nº de comunidades no vacías.
+     */
+    std::size_t getNCommunities() const { return n_communities; }
+
+    /**
+     * @brief Devuelve la capacidad (mayor ID de comunidad posible más uno).
+     */
+    std::size_t getCapacity() const { return sizes.size(); }
+};
+
+} // namespace networkStructure
+
+#endif // COMMUNITYSTATE_H
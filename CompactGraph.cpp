@@ -0,0 +1,343 @@
+#include "CompactGraph.h"
+#include "IdMap.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace networkStructure {
+
+namespace {
+static_assert(sizeof(std::size_t) == sizeof(std::uint64_t), "Los offsets del formato binario son de 64 bits");
+
+const char BINARY_MAGIC[8] = {'C', 'D', 'G', 'R', 'A', 'P', 'H', '\0'};
+
+// Cabecera del fichero binario (40 bytes)
+struct BinaryHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t flags;
+    std::uint64_t n_nodes;
+    std::uint64_t n_arcs;
+    double total_weight;
+};
+
+// Posición (en bytes) de cada sección del fichero binario
+struct BinaryLayout {
+    std::size_t offsets, neighbors, weights, degrees, self_loops, node_sizes, ids, total;
+};
+
+std::size_t align8(std::size_t bytes) {
+    return (bytes + 7) & ~static_cast<std::size_t>(7);
+}
+
+BinaryLayout computeLayout(std::size_t n, std::size_t arcs, bool has_ids) {
+    BinaryLayout l;
+    l.offsets    = align8(sizeof(BinaryHeader));
+    l.neighbors  = align8(l.offsets + (n + 1) * sizeof(std::uint64_t));
+    l.weights    = align8(l.neighbors + arcs * sizeof(std::int32_t));
+    l.degrees    = align8(l.weights + arcs * sizeof(double));
+    l.self_loops = align8(l.degrees + n * sizeof(double));
+    l.node_sizes = align8(l.self_loops + n * sizeof(double));
+    l.ids        = align8(l.node_sizes + n * sizeof(std::uint32_t));
+    l.total      = has_ids ? align8(l.ids + n * sizeof(std::uint64_t)) : l.ids;
+    return l;
+}
+
+// Escribe un array en su posición, rellenando con ceros el hueco de alineación previo
+void writeSection(std::ofstream& out, std::size_t position, const void* data, std::size_t bytes) {
+    static const char zeros[8] = {0};
+    std::size_t current = static_cast<std::size_t>(out.tellp());
+    if (position > current) out.write(zeros, static_cast<std::streamsize>(position - current));
+    if (bytes > 0) out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+}
+} // namespace
+
+CompactGraph::CompactGraph(const Network& net) {
+    // Traducción ID de la red -> índice denso (los huecos de nodos eliminados se saltan)
+    std::vector<int> index_of(net.getIdBound(), -1);
+    std::vector<const Node*> order;
+    order.reserve(net.getNNodes());
+    for (const auto& ptr : net.getNodes()) {
+        if (!ptr) continue;
+        index_of[ptr->getID()] = static_cast<int>(order.size());
+        order.push_back(ptr.get());
+    }
+    std::size_t n = order.size();
+
+    ids_store.resize(n);
+    offsets_store.assign(n + 1, 0);
+    degrees_store.assign(n, 0.0);
+    self_loops_store.assign(n, 0.0);
+    node_sizes_store.assign(n, 1);
+
+    // Primera pasada: contamos los vecinos de cada nodo para calcular los offsets
+    for (std::size_t i = 0; i < n; ++i) {
+        const Node* node = order[i];
+        ids_store[i] = node->getID();
+        node_sizes_store[i] = node->getSize();
+        std::size_t count = 0;
+        for (Edge* e : node->getAdjList()) {
+            if (e && e->getOpposite(node) != node) ++count;
+        }
+        offsets_store[i + 1] = offsets_store[i] + count;
+    }
+    neighbors_store.resize(offsets_store[n]);
+    weights_store.resize(offsets_store[n]);
+
+    // Segunda pasada: rellenamos vecinos, pesos, grados y bucles
+    for (std::size_t i = 0; i < n; ++i) {
+        const Node* node = order[i];
+        std::size_t pos = offsets_store[i];
+        for (Edge* e : node->getAdjList()) {
+            if (!e) continue;
+            const Node* opposite = e->getOpposite(node);
+            if (!opposite) continue;
+            double w = e->getWeight();
+            if (opposite == node) {
+                self_loops_store[i] += w;
+                degrees_store[i] += 2.0 * w;
+                continue;
+            }
+            neighbors_store[pos] = index_of[opposite->getID()];
+            weights_store[pos] = w;
+            degrees_store[i] += w;
+            ++pos;
+        }
+        total_weight += degrees_store[i];
+    }
+    bindStorage();
+}
+
+CompactGraph::CompactGraph(const std::vector<EdgeRecord>& edges) {
+    // IDs distintos en orden de primera aparición (la misma numeración que usa el cargador de Network)
+    IdMap id_map;
+    id_map.build(edges);
+    ids_store = id_map.getExternalIDs();
+    std::size_t n = ids_store.size();
+
+    offsets_store.assign(n + 1, 0);
+    degrees_store.assign(n, 0.0);
+    self_loops_store.assign(n, 0.0);
+    node_sizes_store.assign(n, 1);
+
+    // Recuento de vecinos de cada nodo (cada arista aparece en sus dos extremos)
+    std::vector<std::pair<int, int>> endpoints(edges.size());
+    for (std::size_t k = 0; k < edges.size(); ++k) {
+        unsigned int u = 0, v = 0;
+        id_map.find(edges[k].origin, u);
+        id_map.find(edges[k].destiny, v);
+        endpoints[k] = {static_cast<int>(u), static_cast<int>(v)};
+        if (u == v) continue;
+        ++offsets_store[u + 1];
+        ++offsets_store[v + 1];
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        offsets_store[i + 1] += offsets_store[i];
+    }
+    neighbors_store.resize(offsets_store[n]);
+    weights_store.resize(offsets_store[n]);
+
+    // Escritura de vecinos, pesos, grados y bucles
+    std::vector<std::size_t> cursor(offsets_store.begin(), offsets_store.end() - 1);
+    for (std::size_t k = 0; k < edges.size(); ++k) {
+        int u = endpoints[k].first;
+        int v = endpoints[k].second;
+        double w = edges[k].weight;
+        if (u == v) {
+            self_loops_store[u] += w;
+            degrees_store[u] += 2.0 * w;
+            continue;
+        }
+        neighbors_store[cursor[u]] = v;
+        weights_store[cursor[u]++] = w;
+        neighbors_store[cursor[v]] = u;
+        weights_store[cursor[v]++] = w;
+        degrees_store[u] += w;
+        degrees_store[v] += w;
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        total_weight += degrees_store[i];
+    }
+    bindStorage();
+}
+
+CompactGraph::CompactGraph(const CompactGraph& base, const std::vector<double>& arc_weights) {
+    std::size_t n = static_cast<std::size_t>(base.getNNodes());
+    ids_store.resize(n);
+    offsets_store.assign(n + 1, 0);
+    degrees_store.resize(n);
+    self_loops_store.resize(n);
+    node_sizes_store.resize(n);
+
+    // Recuento de las entradas que se conservan en cada nodo
+    for (std::size_t i = 0; i < n; ++i) {
+        std::size_t count = 0;
+        for (std::size_t e = base.begin(static_cast<int>(i)); e < base.end(static_cast<int>(i)); ++e) {
+            if (arc_weights[e] > 0.0) ++count;
+        }
+        offsets_store[i + 1] = offsets_store[i] + count;
+    }
+    neighbors_store.resize(offsets_store[n]);
+    weights_store.resize(offsets_store[n]);
+
+    for (std::size_t i = 0; i < n; ++i) {
+        int node = static_cast<int>(i);
+        ids_store[i] = base.getOriginalID(node);
+        self_loops_store[i] = base.getSelfLoop(node);
+        node_sizes_store[i] = base.getNodeSize(node);
+        degrees_store[i] = 2.0 * self_loops_store[i];
+        std::size_t pos = offsets_store[i];
+        for (std::size_t e = base.begin(node); e < base.end(node); ++e) {
+            if (arc_weights[e] <= 0.0) continue;
+            neighbors_store[pos] = base.neighbor(e);
+            weights_store[pos++] = arc_weights[e];
+            degrees_store[i] += arc_weights[e];
+        }
+        total_weight += degrees_store[i];
+    }
+    bindStorage();
+}
+
+void CompactGraph::bindStorage() {
+    offsets    = offsets_store.data();
+    neighbors  = neighbors_store.data();
+    weights    = weights_store.data();
+    degrees    = degrees_store.data();
+    self_loops = self_loops_store.data();
+    node_sizes = node_sizes_store.data();
+    ids        = ids_store.data();
+    n_nodes    = static_cast<int>(ids_store.size());
+    n_arcs     = neighbors_store.size();
+}
+
+bool CompactGraph::saveBinary(const std::string& filename) const {
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "Error: No se pudo crear el archivo " << filename << std::endl;
+        return false;
+    }
+    std::size_t n = static_cast<std::size_t>(n_nodes);
+
+    // La tabla de IDs solo se guarda si no coincide con la numeración densa
+    bool has_ids = false;
+    for (std::size_t i = 0; i < n && !has_ids; ++i) {
+        has_ids = (getOriginalID(static_cast<int>(i)) != i);
+    }
+    BinaryLayout layout = computeLayout(n, n_arcs, has_ids);
+
+    BinaryHeader header;
+    std::memcpy(header.magic, BINARY_MAGIC, sizeof(header.magic));
+    header.version = BINARY_VERSION;
+    header.flags = has_ids ? BINARY_HAS_IDS : 0u;
+    header.n_nodes = n;
+    header.n_arcs = n_arcs;
+    header.total_weight = total_weight;
+
+    writeSection(out, 0, &header, sizeof(header));
+    writeSection(out, layout.offsets, offsets, (n + 1) * sizeof(std::uint64_t));
+    writeSection(out, layout.neighbors, neighbors, n_arcs * sizeof(std::int32_t));
+    writeSection(out, layout.weights, weights, n_arcs * sizeof(double));
+    writeSection(out, layout.degrees, degrees, n * sizeof(double));
+    writeSection(out, layout.self_loops, self_loops, n * sizeof(double));
+    writeSection(out, layout.node_sizes, node_sizes, n * sizeof(std::uint32_t));
+    if (has_ids) {
+        writeSection(out, layout.ids, ids, n * sizeof(std::uint64_t));
+    }
+    writeSection(out, layout.total, nullptr, 0);
+
+    if (!out) {
+        std::cerr << "Error: Fallo al escribir el archivo " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool CompactGraph::loadBinary(const std::string& filename, bool validate) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Error: No se pudo abrir el archivo " << filename << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(BinaryHeader)) {
+        std::cerr << "Error: " << filename << " no es un grafo binario valido." << std::endl;
+        ::close(fd);
+        return false;
+    }
+    std::size_t file_size = static_cast<std::size_t>(st.st_size);
+    void* base = ::mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // la proyección sigue siendo válida tras cerrar el descriptor
+    if (base == MAP_FAILED) {
+        std::cerr << "Error: No se pudo proyectar en memoria el archivo " << filename << std::endl;
+        return false;
+    }
+    std::shared_ptr<void> region(base, [file_size](void* p) { ::munmap(p, file_size); });
+
+    const char* bytes = static_cast<const char*>(base);
+    BinaryHeader header;
+    std::memcpy(&header, bytes, sizeof(header));
+    if (std::memcmp(header.magic, BINARY_MAGIC, sizeof(header.magic)) != 0 || header.version != BINARY_VERSION) {
+        std::cerr << "Error: " << filename << " no es un grafo binario valido (version " << BINARY_VERSION << ")." << std::endl;
+        return false;
+    }
+    bool has_ids = (header.flags & BINARY_HAS_IDS) != 0;
+    // Los índices de nodo son int y cada arco ocupa varios bytes del fichero: cotas que evitan desbordar el
+    // cálculo del tamaño esperado con cabeceras corruptas
+    if (header.n_nodes > static_cast<std::uint64_t>(std::numeric_limits<int>::max()) || header.n_arcs > file_size) {
+        std::cerr << "Error: " << filename << " no es un grafo binario valido." << std::endl;
+        return false;
+    }
+    BinaryLayout layout = computeLayout(header.n_nodes, header.n_arcs, has_ids);
+    if (layout.total > file_size) {
+        std::cerr << "Error: " << filename << " esta truncado." << std::endl;
+        return false;
+    }
+
+    // Comprobación opcional del CSR: offsets[0] == 0, offsets no decrecientes, offsets[n] == nº de arcos
+    // y todos los vecinos en [0, n)
+    if (validate) {
+        const std::size_t* file_offsets = reinterpret_cast<const std::size_t*>(bytes + layout.offsets);
+        const int* file_neighbors = reinterpret_cast<const int*>(bytes + layout.neighbors);
+        const long n = static_cast<long>(header.n_nodes);
+        const long m = static_cast<long>(header.n_arcs);
+        bool valid_csr = file_offsets[0] == 0 && file_offsets[n] == header.n_arcs;
+        long bad = 0;
+        #pragma omp parallel for schedule(static) reduction(+:bad)
+        for (long i = 0; i < n; ++i) {
+            if (file_offsets[i] > file_offsets[i + 1]) ++bad;
+        }
+        #pragma omp parallel for schedule(static) reduction(+:bad)
+        for (long k = 0; k < m; ++k) {
+            if (file_neighbors[k] < 0 || file_neighbors[k] >= n) ++bad;
+        }
+        if (!valid_csr || bad != 0) {
+            std::cerr << "Error: " << filename << " no contiene un CSR valido (offsets o vecinos fuera de rango)." << std::endl;
+            return false;
+        }
+    }
+
+    // Las vistas apuntan directamente al fichero: no se copia ni se interpreta ningún dato
+    offsets_store.clear(); neighbors_store.clear(); weights_store.clear(); degrees_store.clear();
+    self_loops_store.clear(); node_sizes_store.clear(); ids_store.clear();
+    offsets    = reinterpret_cast<const std::size_t*>(bytes + layout.offsets);
+    neighbors  = reinterpret_cast<const int*>(bytes + layout.neighbors);
+    weights    = reinterpret_cast<const double*>(bytes + layout.weights);
+    degrees    = reinterpret_cast<const double*>(bytes + layout.degrees);
+    self_loops = reinterpret_cast<const double*>(bytes + layout.self_loops);
+    node_sizes = reinterpret_cast<const unsigned int*>(bytes + layout.node_sizes);
+    ids        = has_ids ? reinterpret_cast<const std::uint64_t*>(bytes + layout.ids) : nullptr;
+    n_nodes    = static_cast<int>(header.n_nodes);
+    n_arcs     = static_cast<std::size_t>(header.n_arcs);
+    total_weight = header.total_weight;
+    mapping = std::move(region);
+    return true;
+}
+
+} // namespace networkStructure
@@ -0,0 +1,182 @@
+#ifndef COMPACTGRAPH_H
+#define COMPACTGRAPH_H
+
+#include "Network.h"
+#include "EdgeListParser.h"
+
+#include <vector>
+#include <memory>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+namespace networkStructure {
+
+/**
+ * @class CompactGraph
+ * @brief Instantánea inmutable de una red en formato CSR (Compressed Sparse Row).
+ * @details Los nodos se renumeran con índices densos 0..n-1 (en orden de ID de la red) y las
+ * aristas se almacenan en tres vectores contiguos: offsets, índices de vecinos y pesos. Los vecinos
+ * del nodo i ocupan el rango [offsets[i], offsets[i+1]). Cada arista no dirigida aparece dos veces,
+ * una en cada extremo. Los bucles (self-loops) no se guardan en la lista de vecinos, sino en
+ * getSelfLoop(), porque se desplazan junto al nodo y no cuentan como peso hacia su comunidad.
+ *
+ * Los accesores trabajan sobre punteros a los arrays, que pueden apuntar a vectores propios (si se
+ * construye desde una Network) o directamente a un fichero binario proyectado en memoria con mmap
+ * (loadBinary()), sin copiar ni interpretar los datos.
+ *
+ * Formato binario (little-endian, cada sección alineada a 8 bytes):
+ *  - Cabecera: magic "CDGRAPH" + '\0', versión (uint32), flags (uint32), n (uint64), nº de entradas (uint64), 2m (double).
+ *  - offsets (uint64, n+1), vecinos (int32), pesos (double), grados (double, n), bucles (double, n),
+ *    tamaños de nodo (uint32, n) y, si el flag BINARY_HAS_IDS está activo, IDs originales (uint64, n).
+ */
+class CompactGraph {
+private:
+    // Almacenamiento propio cuando la instantánea se construye desde una Network
+    std::vector<std::size_t> offsets_store;
+    std::vector<int> neighbors_store;
+    std::vector<double> weights_store;
+    std::vector<double> degrees_store;
+    std::vector<double> self_loops_store;
+    std::vector<unsigned int> node_sizes_store;
+    std::vector<std::uint64_t> ids_store;
+
+    // Vistas usadas por los accesores (vectores propios o fichero proyectado)
+    const std::size_t* offsets = nullptr;     ///< Inicio de los vecinos de cada nodo (tamaño n+1).
+    const int* neighbors = nullptr;           ///< Índice denso del vecino de cada entrada.
+    const double* weights = nullptr;          ///< Peso de cada entrada.
+    const double* degrees = nullptr;          ///< Grado ponderado k_i de cada nodo (los bucles cuentan dos veces).
+    const double* self_loops = nullptr;       ///< Peso total de los bucles de cada nodo.
+    const unsigned int* node_sizes = nullptr; ///< Nº de nodos originales que representa cada nodo (1 si no es supernodo).
+    const std::uint64_t* ids = nullptr;       ///< ID original de cada nodo, o nullptr si coincide con el índice denso.
+    int n_nodes = 0;                          ///< Nº de nodos.
+    std::size_t n_arcs = 0;                   ///< Nº de entradas de adyacencia.
+    double total_weight = 0.0;                ///< Suma de todos los grados (2m).
+
+    std::shared_ptr<void> mapping;            ///< Mantiene proyectado el fichero binario mientras se use.
+
+    /**
+     * @brief Hace que las vistas apunten a los vectores propios.
+     */
+    void bindStorage();
+
+public:
+    static const unsigned int BINARY_VERSION = 2;  ///< Versión del formato binario.
+    static const unsigned int BINARY_HAS_IDS = 1u; ///< Flag: el fichero incluye la tabla de IDs originales.
+
+    /**
+     * @brief Crea una instantánea vacía (0 nodos), que puede rellenarse con loadBinary().
+     */
+    CompactGraph() = default;
+
+    /**
+     * @brief Construye la instantánea CSR a partir de una red en O(n+m).
+     * @param net Red de origen. No se modifica.
+     */
+    explicit CompactGraph(const Network& net);
+
+    /**
+     * @brief Construye la instantánea CSR directamente desde una lista de aristas, sin pasar por Network.
+     * @details Los nodos se numeran en orden de primera aparición de su ID (como hace IdMap al cargar una
+     * Network) y getOriginalID() devuelve el ID externo. El CSR se rellena en una sola pasada de recuento
+     * y otra de escritura.
+     * @param edges Lista de aristas (por ejemplo, la devuelta por parseEdgeListCSV()).
+     */
+    explicit CompactGraph(const std::vector<EdgeRecord>& edges);
+
+    /**
+     * @brief Construye un grafo con los mismos nodos que 'base' y las mismas aristas con nuevos pesos.
+     * @details Conserva la numeración, los bucles, los tamaños de nodo y los IDs originales; las entradas
+     * con peso nuevo <= 0 se descartan y los grados se recalculan. Se usa, por ejemplo, para el grafo de
+     * consenso de Algoritmo::runEnsemble().
+     * @param base Grafo de origen (solo lectura).
+     * @param arc_weights Nuevo peso de cada entrada de adyacencia de 'base' (tamaño getNArcs(); debe ser
+     * simétrico: el mismo valor en las dos entradas de cada arista).
+     */
+    CompactGraph(const CompactGraph& base, const std::vector<double>& arc_weights);
+
+    CompactGraph(const CompactGraph&) = delete;
+    CompactGraph& operator=(const CompactGraph&) = delete;
+    CompactGraph(CompactGraph&&) = default;
+    CompactGraph& operator=(CompactGraph&&) = default;
+
+    /**
+     * @brief Guarda la instantánea en el formato binario.
+     * @param filename Ruta del fichero de salida.
+     * @return true si se escribió correctamente, false en caso contrario.
+     */
+    bool saveBinary(const std::string& filename) const;
+
+    /**
+     * @brief Proyecta en memoria (mmap) un fichero binario y lo usa directamente como grafo.
+     * @details Por defecto solo se validan la cabecera y el tamaño del fichero: el coste es casi constante e
+     * independiente del tamaño de la red, y las páginas se cargan bajo demanda al recorrer el grafo. Con
+     * validate se comprueba además el CSR (offsets[0] == 0, offsets no decrecientes, offsets[n] == nº de
+     * arcos y vecinos en [0, n)), lo que recorre en paralelo todos los offsets y vecinos (O(n + m)).
+     * @param filename Ruta del fichero binario.
+     * @param validate Si es true, comprueba el CSR completo (para ficheros de origen no fiable).
+     * @return true si la carga fue exitosa, false en caso contrario.
+     */
+    bool loadBinary(const std::string& filename, bool validate = false);
+
+    /**
+     * @brief Devuelve el número de nodos.
+     */
+    int getNNodes() const { return n_nodes; }
+
+    /**
+     * @brief Devuelve el número de entradas de adyacencia (2 por arista que no es bucle).
+     */
+    std::size_t getNArcs() const { return n_arcs; }
+
+    /**
+     * @brief Primer índice de la lista de vecinos del nodo i.
+     */
+    std::size_t begin(int i) const { return offsets[i]; }
+
+    /**
+     * @brief Índice siguiente al último vecino del nodo i.
+     */
+    std::size_t end(int i) const { return offsets[i + 1]; }
+
+    /**
+     * @brief Índice denso del vecino almacenado en la posición e.
+     */
+    int neighbor(std::size_t e) const { return neighbors[e]; }
+
+    /**
+     * @brief Peso de la arista almacenada en la posición e.
+     */
+    double weight(std::size_t e) const { return weights[e]; }
+
+    /**
+     * @brief Grado ponderado k_i del nodo i.
+     */
+    double getDegree(int i) const { return degrees[i]; }
+
+    /**
+     * @brief Peso total de los bucles del nodo i.
+     */
+    double getSelfLoop(int i) const { return self_loops[i]; }
+
+    /**
+     * @brief Nº de nodos originales representados por el nodo i (Node::getSize()).
+     */
+    unsigned int getNodeSize(int i) const { return node_sizes[i]; }
+
+    /**
+     * @brief Devuelve el ID original del nodo con índice denso i.
+     * @details Es el ID del nodo en la Network si la instantánea se construyó desde una red, o el ID
+     * externo del fichero si se construyó desde una lista de aristas.
+     */
+    std::uint64_t getOriginalID(int i) const { return ids ? ids[i] : static_cast<std::uint64_t>(i); }
+
+    /**
+     * @brief Suma de todos los grados ponderados (2m).
+     */
+    double getTotalWeight() const { return total_weight; }
+};
+
+} // namespace networkStructure
+
+#endif // COMPACTGRAPH_H
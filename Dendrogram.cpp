@@ -0,0 +1,62 @@
+#include "Dendrogram.h"
+
+#include <algorithm>
+#include <utility>
+#include <omp.h>
+
+namespace networkStructure {
+
+void Dendrogram::addLevel(std::vector<int> parent) {
+    parents.push_back(std::move(parent));
+}
+
+int Dendrogram::getNode(unsigned int original, std::size_t level) const {
+    if (parents.empty()) return static_cast<int>(original);
+    if (original >= parents[0].size()) return -1;
+    int node = static_cast<int>(original);
+    for (std::size_t l = 0; l < level && node >= 0; ++l) {
+        node = parents[l][node];
+    }
+    return node;
+}
+
+std::vector<int> Dendrogram::flatten(std::size_t level) const {
+    std::vector<int> node_of(getIdBound());
+    const long n = static_cast<long>(node_of.size());
+    // Cada nodo original sube por los niveles de forma independiente
+    #pragma omp parallel for schedule(static)
+    for (long i = 0; i < n; ++i) {
+        int node = static_cast<int>(i);
+        for (std::size_t l = 0; l < level && node >= 0; ++l) {
+            node = parents[l][node];
+        }
+        node_of[i] = node;
+    }
+    return node_of;
+}
+
+std::vector<int> Dendrogram::flattenLabels(const std::vector<int>& labels) const {
+    if (parents.empty()) return labels;
+    std::vector<int> result = flatten(parents.size());
+    const long n = static_cast<long>(result.size());
+    #pragma omp parallel for schedule(static)
+    for (long i = 0; i < n; ++i) {
+        if (result[i] >= 0) result[i] = labels[result[i]];
+    }
+    return result;
+}
+
+std::vector<std::vector<unsigned int>> Dendrogram::getMembers(std::size_t level) const {
+    std::vector<int> node_of = flatten(level);
+    std::size_t bound = 0;
+    for (int node : node_of) {
+        bound = std::max(bound, static_cast<std::size_t>(node + 1));
+    }
+    std::vector<std::vector<unsigned int>> members(bound);
+    for (std::size_t i = 0; i < node_of.size(); ++i) {
+        if (node_of[i] >= 0) members[node_of[i]].push_back(static_cast<unsigned int>(i));
+    }
+    return members;
+}
+
+} // namespace networkStructure
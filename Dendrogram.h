@@ -0,0 +1,84 @@
+#ifndef DENDROGRAM_H
+#define DENDROGRAM_H
+
+#include <cstddef>
+#include <vector>
+
+namespace networkStructure {
+
+/**
+ * @class Dendrogram
+ * @brief Jerarquía de agregaciones de una red guardada como un vector de padres por nivel.
+ * @details El nivel 0 son los nodos originales (indexados por su ID) y cada agregación añade un nivel:
+ * parents[l][v] es el nodo del nivel l + 1 que contiene al nodo v del nivel l (-1 si el ID no tiene nodo).
+ * Registrar una agregación cuesta O(nº de nodos del nivel) y el nodo de cualquier nivel que contiene a un
+ * nodo original se obtiene en O(niveles), sin copiar listas de miembros en los supernodos.
+ */
+class Dendrogram {
+private:
+    std::vector<std::vector<int>> parents; ///< Padre de cada nodo de cada nivel en el nivel siguiente.
+
+public:
+    /**
+     * @brief Elimina todos los niveles.
+     */
+    void clear() { parents.clear(); }
+
+    /**
+     * @brief Registra una agregación del nivel superior actual.
+     * @param parent Nodo del nuevo nivel de cada ID de nodo del nivel superior actual (-1 si no tiene nodo).
+     */
+    void addLevel(std::vector<int> parent);
+
+    /**
+     * @brief Devuelve el nº de agregaciones registradas (el nivel superior).
+     */
+    std::size_t getNLevels() const { return parents.size(); }
+
+    /**
+     * @brief Devuelve el vector de padres de un nivel (ver la descripción de la clase).
+     * @param level Nivel en [0, getNLevels()).
+     */
+    const std::vector<int>& getParents(std::size_t level) const { return parents[level]; }
+
+    /**
+     * @brief Devuelve el mayor ID de nodo original más uno (0 si no hay niveles).
+     */
+    std::size_t getIdBound() const { return parents.empty() ? 0 : parents[0].size(); }
+
+    /**
+     * @brief Devuelve el nodo de un nivel que contiene a un nodo original, en O(level).
+     * @param original ID del nodo original.
+     * @param level Nivel en [0, getNLevels()]; el nivel 0 devuelve el propio ID.
+     * @return ID del nodo en ese nivel, o -1 si el ID original no tiene nodo.
+     */
+    int getNode(unsigned int original, std::size_t level) const;
+
+    /**
+     * @brief Calcula en paralelo el nodo de un nivel que contiene a cada nodo original.
+     * @param level Nivel en [0, getNLevels()].
+     * @return Vector indexado por ID original (-1 para IDs sin nodo).
+     */
+    std::vector<int> flatten(std::size_t level) const;
+
+    /**
+     * @brief Extiende a los nodos originales una etiqueta definida sobre los nodos del nivel superior.
+     * @details Calcula en paralelo labels[nodo del nivel superior que contiene a cada nodo original]. Sin
+     * niveles, los nodos originales son los del nivel superior y se devuelve una copia de 'labels'.
+     * @param labels Etiqueta (p. ej. comunidad) de cada ID de nodo del nivel superior (-1 si no tiene nodo).
+     * @return Etiqueta de cada nodo original (-1 para IDs sin nodo).
+     */
+    std::vector<int> flattenLabels(const std::vector<int>& labels) const;
+
+    /**
+     * @brief Agrupa los nodos originales por el nodo de un nivel que los contiene.
+     * @details Se calcula bajo demanda (p. ej. para mostrar los miembros de cada supernodo) en O(n · level).
+     * @param level Nivel en [0, getNLevels()].
+     * @return members[v] = IDs originales contenidos en el nodo v del nivel, en orden creciente.
+     */
+    std::vector<std::vector<unsigned int>> getMembers(std::size_t level) const;
+};
+
+} // namespace networkStructure
+
+#endif // DENDROGRAM_H
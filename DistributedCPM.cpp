@@ -0,0 +1,677 @@
+#include "DistributedCPM.h"
+#include "Algoritmo.h"
+#include "CompactGraph.h"
+#include "NeighborAccumulator.h"
+#include "Network.h"
+#include "QualityFunction.h"
+
+#include <algorithm>
+#include <climits>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <set>
+#include <utility>
+#include <omp.h>
+
+namespace networkStructure {
+
+namespace {
+
+// Proceso que numera cada ID externo (hash de Fibonacci, para repartir bien IDs consecutivos)
+int hashOwner(std::uint64_t id, int n_ranks) {
+    return static_cast<int>(((id * 0x9E3779B97F4A7C15ULL) >> 32) % static_cast<std::uint64_t>(n_ranks));
+}
+
+// Nº de elementos o desplazamiento para una llamada MPI (int): se aborta antes que truncarlo
+int toMpiCount(std::size_t count, MPI_Comm comm) {
+    if (count > static_cast<std::size_t>(INT_MAX)) {
+        std::cerr << "Error: Transferencia MPI de " << count << " elementos, mayor que el limite de " << INT_MAX
+                  << "." << std::endl;
+        MPI_Abort(comm, 1);
+    }
+    return static_cast<int>(count);
+}
+
+// Tipo MPI contiguo de sizeof(T) bytes: los recuentos y desplazamientos van en elementos, no en bytes
+template <typename T>
+class ContiguousType {
+public:
+    ContiguousType() {
+        MPI_Type_contiguous(static_cast<int>(sizeof(T)), MPI_BYTE, &type);
+        MPI_Type_commit(&type);
+    }
+    ~ContiguousType() { MPI_Type_free(&type); }
+    ContiguousType(const ContiguousType&) = delete;
+    ContiguousType& operator=(const ContiguousType&) = delete;
+    MPI_Datatype get() const { return type; }
+
+private:
+    MPI_Datatype type;
+};
+
+// Intercambio todos con todos de elementos agrupados por proceso de destino
+template <typename T, typename Count>
+std::vector<T> exchange(MPI_Comm comm, const std::vector<T>& send, const std::vector<Count>& send_counts,
+                        std::vector<int>& recv_counts) {
+    const int P = static_cast<int>(send_counts.size());
+    std::vector<int> counts(P), send_displs(P), recv_displs(P);
+    std::size_t send_total = 0, recv_total = 0;
+    for (int p = 0; p < P; ++p) {
+        counts[p] = toMpiCount(static_cast<std::size_t>(send_counts[p]), comm);
+        send_displs[p] = toMpiCount(send_total, comm);
+        send_total += static_cast<std::size_t>(send_counts[p]);
+    }
+    recv_counts.assign(P, 0);
+    MPI_Alltoall(counts.data(), 1, MPI_INT, recv_counts.data(), 1, MPI_INT, comm);
+    for (int p = 0; p < P; ++p) {
+        recv_displs[p] = toMpiCount(recv_total, comm);
+        recv_total += static_cast<std::size_t>(recv_counts[p]);
+    }
+    std::vector<T> recv(recv_total);
+    ContiguousType<T> type;
+    MPI_Alltoallv(send.data(), counts.data(), send_displs.data(), type.get(), recv.data(), recv_counts.data(),
+                  recv_displs.data(), type.get(), comm);
+    return recv;
+}
+
+// Mayor fracción inversa de nodos que se mueven por barrido tras deshacer barridos (ver localMoving())
+const std::uint64_t MAX_STRIDE = 8;
+
+// Fracción de la mejora del nivel por debajo de la cual un barrido se considera estancado
+const double STALL_RATIO = 1e-3;
+
+// Cambio del tamaño y del nº de nodos de una comunidad, enviado a su dueño
+struct CommunityDelta {
+    std::uint64_t comm;
+    std::int64_t size;
+    std::int64_t count;
+};
+
+// Propuesta de movimiento de un nodo propio
+struct Proposal {
+    std::uint32_t node; // índice local del nodo
+    int dest;           // comunidad destino (posición en la tabla de comunidades del barrido)
+    double dQ;          // ganancia estimada con el estado del inicio del barrido
+};
+
+// Índice de cada ID en un vector ordenado que lo contiene
+std::size_t indexOf(const std::vector<std::uint64_t>& sorted, std::uint64_t id) {
+    return static_cast<std::size_t>(std::lower_bound(sorted.begin(), sorted.end(), id) - sorted.begin());
+}
+
+std::vector<std::uint64_t> sortedUnique(std::vector<std::uint64_t> values) {
+    std::sort(values.begin(), values.end());
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+    return values;
+}
+
+} // namespace
+
+DistributedCPM::DistributedCPM(MPI_Comm comm) : comm(comm), rank(0), n_ranks(1) {
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &n_ranks);
+    level.offsets.assign(n_ranks + 1, 0);
+}
+
+int DistributedCPM::owner(const Level& lvl, std::uint64_t id) const {
+    // Último proceso cuyo bloque empieza en id o antes (los bloques vacíos se saltan)
+    return static_cast<int>(std::upper_bound(lvl.offsets.begin(), lvl.offsets.end(), id) - lvl.offsets.begin()) - 1;
+}
+
+void DistributedCPM::mergeArcs(std::vector<Arc>& arcs) {
+    std::sort(arcs.begin(), arcs.end(), [](const Arc& x, const Arc& y) {
+        return x.a < y.a || (x.a == y.a && x.b < y.b);
+    });
+    std::size_t m = 0;
+    for (std::size_t k = 0; k < arcs.size(); ++k) {
+        if (m > 0 && arcs[m - 1].a == arcs[k].a && arcs[m - 1].b == arcs[k].b) {
+            arcs[m - 1].w += arcs[k].w;
+        } else {
+            arcs[m++] = arcs[k];
+        }
+    }
+    arcs.resize(m);
+}
+
+void DistributedCPM::buildLevel(Level& lvl, std::vector<std::uint64_t> offsets, std::vector<Arc>& arcs,
+                                std::vector<std::int64_t> sizes) {
+    lvl.offsets = std::move(offsets);
+    lvl.sizes = std::move(sizes);
+    const std::uint64_t first = lvl.offsets[rank];
+    const std::size_t n = lvl.getNLocal();
+    mergeArcs(arcs);
+
+    // Bucles aparte y grado de cada nodo propio; los vecinos de otros procesos son fantasmas
+    lvl.self_loops.assign(n, 0.0);
+    lvl.row.assign(n + 1, 0);
+    lvl.ghosts.clear();
+    for (const Arc& arc : arcs) {
+        if (arc.a == arc.b) {
+            lvl.self_loops[arc.a - first] += arc.w;
+            continue;
+        }
+        ++lvl.row[arc.a - first + 1];
+        if (arc.b < first || arc.b >= first + n) lvl.ghosts.push_back(arc.b);
+    }
+    lvl.ghosts = sortedUnique(std::move(lvl.ghosts));
+    for (std::size_t i = 0; i < n; ++i) lvl.row[i + 1] += lvl.row[i];
+
+    // CSR con los vecinos como índices locales: los propios en [0, n) y los fantasmas a continuación
+    lvl.adj.resize(lvl.row[n]);
+    lvl.weights.resize(lvl.row[n]);
+    std::size_t pos = 0;
+    for (const Arc& arc : arcs) {
+        if (arc.a == arc.b) continue;
+        bool local = arc.b >= first && arc.b < first + n;
+        lvl.adj[pos] = static_cast<std::uint32_t>(local ? arc.b - first : n + indexOf(lvl.ghosts, arc.b));
+        lvl.weights[pos] = arc.w;
+        ++pos;
+    }
+    arcs.clear();
+    arcs.shrink_to_fit();
+
+    // Intercambio de etiquetas: los fantasmas están ordenados y, por tanto, agrupados por dueño; cada
+    // dueño recibe la lista de nodos suyos que otro proceso necesita
+    std::vector<std::size_t> ghost_counts(n_ranks, 0);
+    for (std::uint64_t g : lvl.ghosts) ++ghost_counts[owner(lvl, g)];
+    std::vector<std::uint64_t> requested = exchange(comm, lvl.ghosts, ghost_counts, lvl.halo_send_counts);
+    lvl.halo_recv_counts.assign(n_ranks, 0);
+    for (int p = 0; p < n_ranks; ++p) lvl.halo_recv_counts[p] = static_cast<int>(ghost_counts[p]);
+    // exchangeHalo() usa desplazamientos int: se comprueba aquí que caben
+    toMpiCount(lvl.ghosts.size(), comm);
+    toMpiCount(requested.size(), comm);
+    lvl.halo_send.resize(requested.size());
+    for (std::size_t k = 0; k < requested.size(); ++k) {
+        lvl.halo_send[k] = static_cast<std::uint32_t>(requested[k] - first);
+    }
+}
+
+template <typename T>
+std::vector<T> DistributedCPM::fetch(const std::vector<std::uint64_t>& keys, const std::vector<T>& owned) const {
+    std::vector<std::size_t> counts(n_ranks, 0);
+    for (std::uint64_t key : keys) ++counts[owner(level, key)];
+    std::vector<int> request_counts;
+    std::vector<std::uint64_t> requests = exchange(comm, keys, counts, request_counts);
+    const std::uint64_t first = level.offsets[rank];
+    std::vector<T> reply(requests.size());
+    for (std::size_t k = 0; k < requests.size(); ++k) {
+        reply[k] = owned[requests[k] - first];
+    }
+    std::vector<int> reply_counts;
+    return exchange(comm, reply, request_counts, reply_counts);
+}
+
+void DistributedCPM::exchangeHalo() {
+    const std::size_t n = level.getNLocal();
+    std::vector<std::uint64_t> send(level.halo_send.size());
+    for (std::size_t k = 0; k < send.size(); ++k) {
+        send[k] = labels[level.halo_send[k]];
+    }
+    std::vector<int> send_displs(n_ranks, 0), recv_displs(n_ranks, 0);
+    for (int p = 1; p < n_ranks; ++p) {
+        send_displs[p] = send_displs[p - 1] + level.halo_send_counts[p - 1];
+        recv_displs[p] = recv_displs[p - 1] + level.halo_recv_counts[p - 1];
+    }
+    // Las etiquetas recibidas se escriben directamente en las posiciones de los fantasmas
+    MPI_Alltoallv(send.data(), level.halo_send_counts.data(), send_displs.data(), MPI_UINT64_T, labels.data() + n,
+                  level.halo_recv_counts.data(), recv_displs.data(), MPI_UINT64_T, comm);
+}
+
+double DistributedCPM::evaluateQuality(double gamma) const {
+    const CPMQuality policy(gamma, 0.0, 0.0);
+    const long n = static_cast<long>(level.getNLocal());
+    // Peso interno (cada arista mitad desde cada extremo, bucles una vez) y penalización de las comunidades propias
+    double internal = 0.0;
+    double penalty = 0.0;
+    #pragma omp parallel for schedule(static) reduction(+:internal, penalty)
+    for (long i = 0; i < n; ++i) {
+        internal += level.self_loops[i];
+        for (std::size_t e = level.row[i]; e < level.row[i + 1]; ++e) {
+            if (labels[level.adj[e]] == labels[i]) internal += 0.5 * level.weights[e];
+        }
+        if (comm_counts[i] > 0) penalty += policy.penalty(static_cast<double>(comm_sizes[i]), 0.0);
+    }
+    double local[2] = {internal, penalty};
+    double global[2] = {0.0, 0.0};
+    MPI_Allreduce(local, global, 2, MPI_DOUBLE, MPI_SUM, comm);
+    return global[0] - global[1];
+}
+
+unsigned long DistributedCPM::localMoving(double gamma, double min_gain, int max_sweeps, DistributedResult& result,
+                                          double& quality) {
+    const std::size_t n = level.getNLocal();
+    const std::uint64_t first = level.offsets[rank];
+    const CPMQuality policy(gamma, 0.0, 0.0);
+
+    // Partición inicial: cada nodo en su comunidad (ID de comunidad = ID del nodo)
+    labels.resize(n + level.ghosts.size());
+    for (std::size_t i = 0; i < n; ++i) labels[i] = first + i;
+    std::copy(level.ghosts.begin(), level.ghosts.end(), labels.begin() + static_cast<std::ptrdiff_t>(n));
+    comm_sizes = level.sizes;
+    comm_counts.assign(n, 1);
+    quality = evaluateQuality(gamma);
+    const double start_quality = quality;
+
+    int P = omp_get_max_threads();
+    if (P < 1) P = 1;
+    std::vector<NeighborAccumulator> thread_weights(P);
+    std::vector<std::vector<Proposal>> proposals(P);
+    NeighborAccumulator commit_weights;
+    std::vector<int> slot(labels.size());
+    unsigned long kept = 0;
+    // Tras deshacer un barrido solo se mueve uno de cada 'stride' nodos (por ID), para reducir los
+    // movimientos simultáneos que chocan entre procesos
+    std::uint64_t stride = 1;
+    std::vector<char> boundary(n, 0);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t e = level.row[i]; e < level.row[i + 1] && !boundary[i]; ++e) boundary[i] = level.adj[e] >= n;
+    }
+
+    for (int sweep = 0; sweep < max_sweeps; ++sweep) {
+        ++result.sweeps;
+        // Comunidades que aparecen en este proceso y sus agregados al inicio del barrido. Los bucles
+        // internos trabajan con su posición en esta tabla (slot) en lugar de con el ID global.
+        std::vector<std::uint64_t> comms = sortedUnique(labels);
+        std::vector<std::int64_t> slot_sizes = fetch(comms, comm_sizes);
+        std::vector<std::int64_t> slot_counts = fetch(comms, comm_counts);
+        const long n_labels = static_cast<long>(labels.size());
+        #pragma omp parallel for schedule(static)
+        for (long v = 0; v < n_labels; ++v) {
+            slot[v] = static_cast<int>(indexOf(comms, labels[v]));
+        }
+
+        auto accumulate = [&](std::size_t i, NeighborAccumulator& acc) {
+            acc.clear();
+            for (std::size_t e = level.row[i]; e < level.row[i + 1]; ++e) {
+                acc.add(slot[level.adj[e]], level.weights[e]);
+            }
+        };
+        auto gainTo = [&](std::size_t i, const NeighborAccumulator& acc, int cur, int dest) {
+            // Dos nodos solos en su comunidad solo se unen hacia la etiqueta menor: sin esta regla, dos
+            // vecinos de procesos distintos pueden intercambiarse en cada barrido
+            if (slot_counts[cur] == 1 && slot_counts[dest] == 1 && comms[dest] > comms[cur]) {
+                return -std::numeric_limits<double>::infinity();
+            }
+            return policy.gain(acc.get(dest), acc.get(cur), static_cast<double>(level.sizes[i]), 0.0,
+                               static_cast<double>(slot_sizes[cur]), 0.0, static_cast<double>(slot_sizes[dest]), 0.0);
+        };
+
+        // Propuestas en paralelo con el estado del inicio del barrido
+        #pragma omp parallel num_threads(P)
+        {
+            int tid = omp_get_thread_num();
+            NeighborAccumulator& acc = thread_weights[tid];
+            if (acc.getCapacity() < comms.size()) acc.resize(comms.size());
+            proposals[tid].clear();
+            #pragma omp for schedule(dynamic, 256)
+            for (long i = 0; i < static_cast<long>(n); ++i) {
+                if (stride > 1 && boundary[i] && (first + i) % stride != static_cast<std::uint64_t>(sweep) % stride) continue;
+                accumulate(i, acc);
+                int cur = slot[i];
+                int best = -1;
+                double best_dQ = min_gain;
+                for (int key : acc.getKeys()) {
+                    if (key == cur) continue;
+                    double dQ = gainTo(i, acc, cur, key);
+                    if (dQ > best_dQ || (best != -1 && dQ == best_dQ && comms[key] < comms[best])) {
+                        best = key;
+                        best_dQ = dQ;
+                    }
+                }
+                if (best != -1) proposals[tid].push_back({static_cast<std::uint32_t>(i), best, best_dQ});
+            }
+        }
+
+        // Validación diferida como en el modo BATCH: primero las de mayor ΔQ, recalculado con el estado
+        // local actual (los movimientos de otros procesos se ven al sincronizar)
+        std::vector<Proposal> batch;
+        for (int t = 0; t < P; ++t) batch.insert(batch.end(), proposals[t].begin(), proposals[t].end());
+        std::sort(batch.begin(), batch.end(), [](const Proposal& a, const Proposal& b) {
+            return a.dQ > b.dQ || (a.dQ == b.dQ && a.node < b.node);
+        });
+        if (commit_weights.getCapacity() < comms.size()) commit_weights.resize(comms.size());
+        std::vector<std::int64_t> delta_sizes(comms.size(), 0);
+        std::vector<std::int64_t> delta_counts(comms.size(), 0);
+        std::vector<std::pair<std::uint32_t, std::uint64_t>> moved; // nodo y etiqueta anterior
+        for (const Proposal& prop : batch) {
+            int cur = slot[prop.node];
+            if (cur == prop.dest) continue;
+            accumulate(prop.node, commit_weights);
+            if (!commit_weights.contains(prop.dest)) continue;
+            if (gainTo(prop.node, commit_weights, cur, prop.dest) <= min_gain) continue;
+            std::int64_t s = level.sizes[prop.node];
+            slot_sizes[cur] -= s;
+            slot_sizes[prop.dest] += s;
+            --slot_counts[cur];
+            ++slot_counts[prop.dest];
+            delta_sizes[cur] -= s;
+            delta_sizes[prop.dest] += s;
+            --delta_counts[cur];
+            ++delta_counts[prop.dest];
+            moved.emplace_back(prop.node, labels[prop.node]);
+            slot[prop.node] = prop.dest;
+            labels[prop.node] = comms[prop.dest];
+        }
+
+        // Sincronización en bloque: cambios de cada comunidad a su dueño y etiquetas frontera a los fantasmas
+        auto sendDeltas = [&](std::int64_t sign) {
+            std::vector<CommunityDelta> out;
+            std::vector<std::size_t> counts(n_ranks, 0);
+            for (std::size_t s = 0; s < comms.size(); ++s) {
+                if (delta_sizes[s] == 0 && delta_counts[s] == 0) continue;
+                out.push_back({comms[s], sign * delta_sizes[s], sign * delta_counts[s]});
+                ++counts[owner(level, comms[s])];
+            }
+            std::vector<int> recv_counts;
+            for (const CommunityDelta& d : exchange(comm, out, counts, recv_counts)) {
+                comm_sizes[d.comm - first] += d.size;
+                comm_counts[d.comm - first] += d.count;
+            }
+        };
+        sendDeltas(1);
+        exchangeHalo();
+
+        unsigned long local_moves = moved.size();
+        unsigned long total_moves = 0;
+        MPI_Allreduce(&local_moves, &total_moves, 1, MPI_UNSIGNED_LONG, MPI_SUM, comm);
+        if (total_moves == 0) break;
+
+        // Los movimientos simultáneos de procesos distintos pueden empeorar la calidad: se deshace el barrido
+        double new_quality = evaluateQuality(gamma);
+        if (new_quality < quality) {
+            for (const auto& m : moved) labels[m.first] = m.second;
+            sendDeltas(-1);
+            exchangeHalo();
+            if (stride >= MAX_STRIDE) break;
+            stride *= 2;
+            continue;
+        }
+        kept += total_moves;
+        result.moves += total_moves;
+        double improvement = new_quality - quality;
+        quality = new_quality;
+        if (improvement <= min_gain) break;
+        if (improvement < STALL_RATIO * (quality - start_quality)) {
+            // Mejora residual: los movimientos que quedan son sobre todo nodos frontera que oscilan
+            if (stride >= MAX_STRIDE) break;
+            stride *= 2;
+        }
+    }
+    return kept;
+}
+
+void DistributedCPM::aggregate() {
+    const std::size_t n = level.getNLocal();
+
+    // Nuevo ID de cada comunidad propia no vacía: los supernodos siguen en el proceso dueño de la comunidad
+    std::uint64_t n_new = 0;
+    for (std::size_t c = 0; c < n; ++c) n_new += comm_counts[c] > 0 ? 1 : 0;
+    std::vector<std::uint64_t> all_counts(n_ranks, 0);
+    MPI_Allgather(&n_new, 1, MPI_UINT64_T, all_counts.data(), 1, MPI_UINT64_T, comm);
+    std::vector<std::uint64_t> new_offsets(n_ranks + 1, 0);
+    for (int p = 0; p < n_ranks; ++p) new_offsets[p + 1] = new_offsets[p] + all_counts[p];
+    std::vector<std::uint64_t> new_id(n, 0);
+    std::vector<std::int64_t> new_sizes;
+    new_sizes.reserve(n_new);
+    for (std::size_t c = 0; c < n; ++c) {
+        if (comm_counts[c] == 0) continue;
+        new_id[c] = new_offsets[rank] + new_sizes.size();
+        new_sizes.push_back(comm_sizes[c]);
+    }
+
+    // Supernodo de cada nodo propio y fantasma
+    std::vector<std::uint64_t> comms = sortedUnique(labels);
+    std::vector<std::uint64_t> comm_new = fetch(comms, new_id);
+    std::vector<std::uint64_t> coarse(labels.size());
+    const long n_labels = static_cast<long>(labels.size());
+    #pragma omp parallel for schedule(static)
+    for (long v = 0; v < n_labels; ++v) {
+        coarse[v] = comm_new[indexOf(comms, labels[v])];
+    }
+
+    // Aristas agregadas (C(i), C(j), w); las internas de una comunidad forman el bucle del supernodo, con
+    // la mitad del peso desde cada extremo. Se fusionan aquí para enviar una sola por par de supernodos.
+    std::vector<Arc> arcs;
+    arcs.reserve(level.adj.size() + n);
+    for (std::size_t i = 0; i < n; ++i) {
+        std::uint64_t a = coarse[i];
+        if (level.self_loops[i] != 0.0) arcs.push_back({a, a, level.self_loops[i]});
+        for (std::size_t e = level.row[i]; e < level.row[i + 1]; ++e) {
+            std::uint64_t b = coarse[level.adj[e]];
+            arcs.push_back({a, b, a == b ? 0.5 * level.weights[e] : level.weights[e]});
+        }
+    }
+    mergeArcs(arcs);
+    Level next;
+    next.offsets = new_offsets;
+    std::vector<std::size_t> counts(n_ranks, 0);
+    for (const Arc& arc : arcs) ++counts[owner(next, arc.a)];
+    std::vector<int> recv_counts;
+    std::vector<Arc> received = exchange(comm, arcs, counts, recv_counts);
+    arcs.clear();
+    arcs.shrink_to_fit();
+
+    // Supernodo que contiene a cada nodo original propio (lo sabe el dueño de su nodo del nivel actual)
+    std::vector<std::uint64_t> keys = sortedUnique(original_node);
+    coarse.resize(n);
+    std::vector<std::uint64_t> parents = fetch(keys, coarse);
+    for (std::uint64_t& node : original_node) {
+        node = parents[indexOf(keys, node)];
+    }
+
+    buildLevel(next, std::move(new_offsets), received, std::move(new_sizes));
+    level = std::move(next);
+    labels.clear();
+    comm_sizes.clear();
+    comm_counts.clear();
+}
+
+void DistributedCPM::gatherAndFinish(double gamma, double min_gain, bool refine, DistributedResult& result) {
+    const std::size_t n = level.getNLocal();
+    const std::uint64_t first = level.offsets[rank];
+    const std::uint64_t n_global = level.getNGlobal();
+
+    // Aristas propias una sola vez (a < b) y bucles, con IDs globales del nivel
+    std::vector<EdgeRecord> records;
+    for (std::size_t i = 0; i < n; ++i) {
+        std::uint64_t a = first + i;
+        if (level.self_loops[i] != 0.0) records.push_back({a, a, level.self_loops[i]});
+        for (std::size_t e = level.row[i]; e < level.row[i + 1]; ++e) {
+            std::uint64_t b = level.adj[e] < n ? first + level.adj[e] : level.ghosts[level.adj[e] - n];
+            if (a < b) records.push_back({a, b, level.weights[e]});
+        }
+    }
+
+    // Reunión en el proceso 0: tamaños en orden de ID (bloques consecutivos) y aristas, con recuentos y
+    // desplazamientos en elementos y comprobados antes de pasarlos a int
+    int sizes_count = toMpiCount(n, comm);
+    int records_count = toMpiCount(records.size(), comm);
+    std::vector<int> all_sizes_counts(n_ranks, 0), all_records_counts(n_ranks, 0);
+    MPI_Gather(&sizes_count, 1, MPI_INT, all_sizes_counts.data(), 1, MPI_INT, 0, comm);
+    MPI_Gather(&records_count, 1, MPI_INT, all_records_counts.data(), 1, MPI_INT, 0, comm);
+    std::vector<int> sizes_displs(n_ranks, 0), records_displs(n_ranks, 0);
+    std::size_t sizes_total = 0, records_total = 0;
+    for (int p = 0; p < n_ranks; ++p) {
+        sizes_displs[p] = toMpiCount(sizes_total, comm);
+        records_displs[p] = toMpiCount(records_total, comm);
+        sizes_total += static_cast<std::size_t>(all_sizes_counts[p]);
+        records_total += static_cast<std::size_t>(all_records_counts[p]);
+    }
+    std::vector<std::int64_t> all_sizes(rank == 0 ? n_global : 0);
+    std::vector<EdgeRecord> all_records(rank == 0 ? records_total : 0);
+    ContiguousType<EdgeRecord> record_type;
+    MPI_Gatherv(level.sizes.data(), sizes_count, MPI_INT64_T, all_sizes.data(), all_sizes_counts.data(),
+                sizes_displs.data(), MPI_INT64_T, 0, comm);
+    MPI_Gatherv(records.data(), records_count, record_type.get(), all_records.data(), all_records_counts.data(),
+                records_displs.data(), record_type.get(), 0, comm);
+    records.clear();
+
+    // El proceso 0 termina la optimización con el algoritmo multinivel de memoria compartida
+    std::vector<int> final_labels(n_global, -1);
+    double quality = 0.0;
+    std::uint64_t n_communities = 0;
+    if (rank == 0) {
+        Network net;
+        net.reserve(n_global, all_records.size());
+        for (std::uint64_t id = 0; id < n_global; ++id) {
+            net.addNode(static_cast<unsigned int>(id))->setSize(static_cast<unsigned int>(all_sizes[id]));
+        }
+        net.addEdges(all_records);
+        all_records.clear();
+        Algoritmo algoritmo(&net);
+        final_labels = algoritmo.runMultilevel(gamma, min_gain, MoveMode::BATCH, 0, refine, QualityType::CPM);
+        CompactGraph graph(net);
+        quality = Algoritmo::evaluateQuality(graph, final_labels, gamma, QualityType::CPM);
+        n_communities = std::set<int>(final_labels.begin(), final_labels.end()).size();
+    }
+    MPI_Bcast(final_labels.data(), static_cast<int>(n_global), MPI_INT, 0, comm);
+    MPI_Bcast(&quality, 1, MPI_DOUBLE, 0, comm);
+    MPI_Bcast(&n_communities, 1, MPI_UINT64_T, 0, comm);
+
+    communities.resize(original_node.size());
+    for (std::size_t k = 0; k < original_node.size(); ++k) {
+        communities[k] = static_cast<std::uint64_t>(final_labels[original_node[k]]);
+    }
+    result.gathered = true;
+    result.gathered_nodes = n_global;
+    result.quality = quality;
+    result.n_communities = n_communities;
+}
+
+bool DistributedCPM::load(const std::string& filename) {
+    std::vector<EdgeRecord> edges;
+    int ok = parseEdgeListCSV(filename, edges, rank, n_ranks) ? 1 : 0;
+    int all_ok = 0;
+    MPI_Allreduce(&ok, &all_ok, 1, MPI_INT, MPI_MIN, comm);
+    if (!all_ok) {
+        return false;
+    }
+
+    // Numeración distribuida: cada ID externo distinto se envía al proceso que le toca por hash
+    std::vector<std::uint64_t> local_ids;
+    local_ids.reserve(2 * edges.size());
+    for (const EdgeRecord& e : edges) {
+        local_ids.push_back(e.origin);
+        local_ids.push_back(e.destiny);
+    }
+    local_ids = sortedUnique(std::move(local_ids));
+    std::vector<std::size_t> counts(n_ranks, 0);
+    for (std::uint64_t id : local_ids) ++counts[hashOwner(id, n_ranks)];
+    std::vector<std::size_t> starts(n_ranks, 0);
+    for (int p = 1; p < n_ranks; ++p) starts[p] = starts[p - 1] + counts[p - 1];
+    std::vector<std::uint64_t> requests(local_ids.size());
+    std::vector<std::size_t> request_pos(local_ids.size());
+    for (std::size_t k = 0; k < local_ids.size(); ++k) {
+        int p = hashOwner(local_ids[k], n_ranks);
+        request_pos[k] = starts[p]++;
+        requests[request_pos[k]] = local_ids[k];
+    }
+    std::vector<int> recv_counts;
+    std::vector<std::uint64_t> received = exchange(comm, requests, counts, recv_counts);
+
+    // Los IDs de cada proceso, ordenados, forman su bloque de índices densos
+    external_ids = sortedUnique(received);
+    std::uint64_t n_owned = external_ids.size();
+    std::vector<std::uint64_t> all_counts(n_ranks, 0);
+    MPI_Allgather(&n_owned, 1, MPI_UINT64_T, all_counts.data(), 1, MPI_UINT64_T, comm);
+    std::vector<std::uint64_t> offsets(n_ranks + 1, 0);
+    for (int p = 0; p < n_ranks; ++p) offsets[p + 1] = offsets[p] + all_counts[p];
+    const std::uint64_t first = offsets[rank];
+    for (std::uint64_t& id : received) id = first + indexOf(external_ids, id);
+    std::vector<int> reply_counts;
+    std::vector<std::uint64_t> dense = exchange(comm, received, recv_counts, reply_counts);
+
+    // Cada arista va al dueño de cada extremo (una vez si es un bucle)
+    level.offsets = offsets;
+    std::vector<Arc> arcs;
+    arcs.reserve(2 * edges.size());
+    for (const EdgeRecord& e : edges) {
+        std::uint64_t u = dense[request_pos[indexOf(local_ids, e.origin)]];
+        std::uint64_t v = dense[request_pos[indexOf(local_ids, e.destiny)]];
+        arcs.push_back({u, v, e.weight});
+        if (u != v) arcs.push_back({v, u, e.weight});
+    }
+    edges.clear();
+    edges.shrink_to_fit();
+    std::sort(arcs.begin(), arcs.end(), [](const Arc& x, const Arc& y) { return x.a < y.a; });
+    counts.assign(n_ranks, 0);
+    for (const Arc& arc : arcs) ++counts[owner(level, arc.a)];
+    std::vector<Arc> owned_arcs = exchange(comm, arcs, counts, recv_counts);
+    arcs.clear();
+    arcs.shrink_to_fit();
+
+    buildLevel(level, std::move(offsets), owned_arcs, std::vector<std::int64_t>(n_owned, 1));
+    original_node.resize(n_owned);
+    for (std::size_t k = 0; k < n_owned; ++k) original_node[k] = first + k;
+    communities.clear();
+    return true;
+}
+
+DistributedResult DistributedCPM::run(double gamma, double min_gain, std::uint64_t gather_threshold, int max_sweeps,
+                                      bool refine) {
+    double t0 = MPI_Wtime();
+    DistributedResult result;
+    result.n_nodes = level.getNGlobal();
+    communities.clear();
+    if (result.n_nodes == 0) return result;
+    // La red reunida se indexa con int en el proceso 0
+    gather_threshold = std::min<std::uint64_t>(gather_threshold, INT_MAX);
+
+    while (true) {
+        if (level.getNGlobal() <= gather_threshold) {
+            gatherAndFinish(gamma, min_gain, refine, result);
+            break;
+        }
+        double quality = 0.0;
+        unsigned long moves = localMoving(gamma, min_gain, max_sweeps, result, quality);
+        ++result.distributed_levels;
+
+        std::uint64_t local_communities = 0;
+        for (std::int64_t count : comm_counts) local_communities += count > 0 ? 1 : 0;
+        std::uint64_t n_communities = 0;
+        MPI_Allreduce(&local_communities, &n_communities, 1, MPI_UINT64_T, MPI_SUM, comm);
+
+        if (moves == 0 || n_communities == level.getNGlobal()) {
+            // Sin cambios: la comunidad de cada original es la etiqueta de su nodo en este nivel
+            std::vector<std::uint64_t> keys = sortedUnique(original_node);
+            std::vector<std::uint64_t> node_labels = fetch(keys, labels);
+            communities.resize(original_node.size());
+            for (std::size_t k = 0; k < original_node.size(); ++k) {
+                communities[k] = node_labels[indexOf(keys, original_node[k])];
+            }
+            result.quality = quality;
+            result.n_communities = n_communities;
+            break;
+        }
+        aggregate();
+    }
+    result.seconds = MPI_Wtime() - t0;
+    return result;
+}
+
+bool DistributedCPM::writeCommunities(const std::string& filename) const {
+    int ok = 1;
+    // Escritura por turnos: el proceso 0 crea el fichero y los demás añaden sus nodos en orden
+    for (int p = 0; p < n_ranks; ++p) {
+        if (p == rank) {
+            std::ofstream out(filename, p == 0 ? std::ios::trunc : std::ios::app);
+            if (!out.is_open()) {
+                std::cerr << "Error: No se pudo crear el archivo " << filename << std::endl;
+                ok = 0;
+            } else {
+                if (p == 0) out << "nodo,comunidad\n";
+                for (std::size_t k = 0; k < communities.size(); ++k) {
+                    out << external_ids[k] << ',' << communities[k] << '\n';
+                }
+                ok = out.good() ? 1 : 0;
+            }
+        }
+        MPI_Barrier(comm);
+    }
+    int all_ok = 0;
+    MPI_Allreduce(&ok, &all_ok, 1, MPI_INT, MPI_MIN, comm);
+    return all_ok != 0;
+}
+
+} // namespace networkStructure
@@ -0,0 +1,195 @@
+#ifndef DISTRIBUTEDCPM_H
+#define DISTRIBUTEDCPM_H
+
+#include "EdgeListParser.h"
+
+#include <mpi.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace networkStructure {
+
+/**
+ * @struct DistributedResult
+ * @brief Resultado de una ejecución de DistributedCPM::run() (igual en todos los procesos).
+ */
+struct DistributedResult {
+    std::uint64_t n_nodes = 0;          ///< Nº de nodos de la red de entrada.
+    std::uint64_t n_communities = 0;    ///< Nº de comunidades de la partición final.
+    double quality = 0.0;               ///< Calidad CPM de la partición final.
+    unsigned int distributed_levels = 0; ///< Niveles optimizados de forma distribuida.
+    unsigned long sweeps = 0;           ///< Barridos de movimiento local distribuidos.
+    unsigned long moves = 0;            ///< Movimientos aplicados en los barridos distribuidos.
+    bool gathered = false;              ///< true si los últimos niveles se resolvieron en el proceso 0.
+    std::uint64_t gathered_nodes = 0;   ///< Nº de nodos de la red reunida en el proceso 0.
+    double seconds = 0.0;               ///< Tiempo de la optimización (sin la carga).
+};
+
+/**
+ * @class DistributedCPM
+ * @brief Optimización multinivel del CPM con los nodos repartidos entre procesos MPI.
+ * @details Cada proceso lee su parte del CSV (parseEdgeListCSV() por rangos de bytes) y es dueño de un
+ * bloque contiguo de IDs densos: los IDs externos se reparten por hash entre los procesos, cada uno numera
+ * los suyos y el bloque del proceso r es [offsets[r], offsets[r + 1]). Cada proceso guarda en CSR las
+ * aristas de sus nodos y una copia (nodo fantasma) de la etiqueta de cada vecino de otro proceso.
+ *
+ * Cada barrido de movimiento local sigue el esquema BATCH de Algoritmo::run(): los nodos propios proponen
+ * en paralelo (OpenMP) su mejor movimiento con el estado del inicio del barrido, y las propuestas se
+ * validan y aplican en orden de ΔQ con el estado local actualizado. Al final del barrido se sincroniza en
+ * bloque: los cambios de tamaño de cada comunidad se envían a su dueño (el del nodo con su ID) y las
+ * etiquetas de los nodos frontera a los procesos que los tienen como fantasmas. Como los procesos no ven
+ * los movimientos de los demás hasta la sincronización, se calcula la calidad global tras cada barrido:
+ * si la ha empeorado se deshace, y si la ha empeorado o apenas la ha mejorado, en los barridos siguientes
+ * solo se mueve uno de cada 2, 4 u 8 nodos frontera (por ID) para reducir los choques entre procesos.
+ * Además, dos nodos solos en su comunidad solo se unen hacia la etiqueta menor, para evitar que se
+ * intercambien indefinidamente.
+ *
+ * La agregación también es distribuida: cada comunidad pasa a ser un nodo del siguiente nivel, propiedad
+ * del dueño de la comunidad, que recibe las aristas agregadas de sus supernodos. Cuando la red del nivel
+ * tiene como mucho gather_threshold nodos se reúne en el proceso 0, que la termina con
+ * Algoritmo::runMultilevel() y difunde el resultado.
+ *
+ * Todos los métodos son colectivos: deben llamarlos todos los procesos del comunicador.
+ */
+class DistributedCPM {
+private:
+    // Arista dirigida de un nodo propio (a) a un vecino (b), con IDs globales del nivel
+    struct Arc {
+        std::uint64_t a;
+        std::uint64_t b;
+        double w;
+    };
+
+    // Red de un nivel repartida entre los procesos
+    struct Level {
+        std::vector<std::uint64_t> offsets;   ///< Bloque de IDs de cada proceso (n_ranks + 1 valores).
+        std::vector<std::size_t> row;         ///< Inicio de las aristas de cada nodo propio (CSR).
+        std::vector<std::uint32_t> adj;       ///< Vecino: índice local (propios y después fantasmas).
+        std::vector<double> weights;          ///< Peso de cada arista.
+        std::vector<double> self_loops;       ///< Peso de los bucles de cada nodo propio.
+        std::vector<std::int64_t> sizes;      ///< Nº de nodos originales de cada nodo propio.
+        std::vector<std::uint64_t> ghosts;    ///< ID global de cada fantasma, en orden creciente.
+        std::vector<std::uint32_t> halo_send; ///< Nodos propios cuya etiqueta se envía, agrupados por proceso.
+        std::vector<int> halo_send_counts;    ///< Nº de etiquetas enviadas a cada proceso.
+        std::vector<int> halo_recv_counts;    ///< Nº de fantasmas de cada proceso.
+
+        std::size_t getNLocal() const { return sizes.size(); }
+        std::uint64_t getNGlobal() const { return offsets.back(); }
+    };
+
+    MPI_Comm comm;
+    int rank;
+    int n_ranks;
+
+    Level level;                                ///< Red del nivel actual.
+    std::vector<std::uint64_t> external_ids;    ///< ID externo de cada nodo original propio.
+    std::vector<std::uint64_t> original_node;   ///< Nodo del nivel actual que contiene a cada original propio.
+    std::vector<std::uint64_t> communities;     ///< Comunidad final de cada nodo original propio.
+
+    // Estado de la partición del nivel actual
+    std::vector<std::uint64_t> labels;          ///< Comunidad de cada nodo propio y de cada fantasma.
+    std::vector<std::int64_t> comm_sizes;       ///< Tamaño de cada comunidad propia (ID = nodo propio).
+    std::vector<std::int64_t> comm_counts;      ///< Nº de nodos del nivel en cada comunidad propia.
+
+    int owner(const Level& lvl, std::uint64_t id) const;
+
+    /**
+     * @brief Ordena las aristas por (a, b) y suma los pesos de las repetidas.
+     */
+    static void mergeArcs(std::vector<Arc>& arcs);
+
+    /**
+     * @brief Construye la red de un nivel a partir de las aristas de los nodos propios.
+     * @details Fusiona las aristas repetidas, separa los bucles, numera los fantasmas y prepara el
+     * intercambio de etiquetas con los procesos vecinos.
+     */
+    void buildLevel(Level& lvl, std::vector<std::uint64_t> offsets, std::vector<Arc>& arcs,
+                    std::vector<std::int64_t> sizes);
+
+    /**
+     * @brief Pide a sus dueños el valor de cada ID global (claves en orden creciente y sin repetir).
+     * @param keys IDs globales del nivel.
+     * @param owned Valor de cada nodo propio (indexado por ID - offsets[rank]).
+     * @return Valor de cada clave, en el orden de keys.
+     */
+    template <typename T>
+    std::vector<T> fetch(const std::vector<std::uint64_t>& keys, const std::vector<T>& owned) const;
+
+    void exchangeHalo();
+    double evaluateQuality(double gamma) const;
+
+    /**
+     * @brief Movimiento local distribuido del nivel actual desde la partición de nodos aislados.
+     * @return Nº total de movimientos conservados en todos los procesos.
+     */
+    unsigned long localMoving(double gamma, double min_gain, int max_sweeps, DistributedResult& result,
+                              double& quality);
+
+    /**
+     * @brief Agrega las comunidades del nivel actual en la red del siguiente nivel.
+     */
+    void aggregate();
+
+    /**
+     * @brief Reúne la red del nivel actual en el proceso 0, la optimiza con Algoritmo::runMultilevel() y
+     * reparte la comunidad de cada nodo original.
+     */
+    void gatherAndFinish(double gamma, double min_gain, bool refine, DistributedResult& result);
+
+public:
+    /**
+     * @brief Crea el optimizador sobre un comunicador (todos sus procesos participan).
+     */
+    explicit DistributedCPM(MPI_Comm comm = MPI_COMM_WORLD);
+
+    /**
+     * @brief Carga una lista de aristas en CSV repartida entre los procesos.
+     * @details Cada proceso lee su rango de bytes del fichero, los IDs externos se numeran de forma
+     * distribuida y cada arista se envía a los dueños de sus extremos.
+     * @param filename Nombre del archivo CSV (accesible desde todos los procesos).
+     * @return true si todos los procesos pudieron leer su parte, false en caso contrario.
+     */
+    bool load(const std::string& filename);
+
+    /**
+     * @brief Optimiza el CPM sobre la red cargada.
+     * @details La red cargada se consume en la agregación: para otra ejecución hay que volver a llamar
+     * a load().
+     * @param gamma Parámetro de resolución del CPM.
+     * @param min_gain Umbral mínimo de ganancia de calidad para aceptar un movimiento.
+     * @param gather_threshold Nº de nodos por debajo del cual la red se reúne en el proceso 0.
+     * @param max_sweeps Nº máximo de barridos por nivel distribuido.
+     * @param refine Activa el refinamiento de Leiden en los niveles que resuelve el proceso 0.
+     * @return Resumen de la ejecución.
+     */
+    DistributedResult run(double gamma, double min_gain = 0.0, std::uint64_t gather_threshold = 100000,
+                          int max_sweeps = 100, bool refine = false);
+
+    /**
+     * @brief Escribe la partición final en CSV (nodo,comunidad) con los IDs externos.
+     * @details Los procesos escriben por turnos sus nodos en el mismo fichero, sin reunirlos en uno solo.
+     * @param filename Nombre del archivo de salida.
+     * @return true si todos los procesos pudieron escribir, false en caso contrario.
+     */
+    bool writeCommunities(const std::string& filename) const;
+
+    /**
+     * @brief IDs externos de los nodos originales de este proceso.
+     */
+    const std::vector<std::uint64_t>& getExternalIDs() const { return external_ids; }
+
+    /**
+     * @brief Comunidad final de cada nodo original de este proceso (en el orden de getExternalIDs()).
+     */
+    const std::vector<std::uint64_t>& getCommunities() const { return communities; }
+
+    int getRank() const { return rank; }
+    int getNRanks() const { return n_ranks; }
+};
+
+} // namespace networkStructure
+
+#endif // DISTRIBUTEDCPM_H
@@ -9,23 +9,23 @@ Edge::Edge(unsigned int id0, Node* node1, Node* node2, double weight0) {
     weight = weight0;
 }
 
-unsigned int Edge::getID() {
+unsigned int Edge::getID() const {
     return id;
 }
 
-Node* Edge::getOrigin() {
+Node* Edge::getOrigin() const {
     return n1;
 }
 
-Node* Edge::getDestiny() {
+Node* Edge::getDestiny() const {
     return n2;
 }
 
-double Edge::getWeight() {
+double Edge::getWeight() const {
     return weight;
 }
 
-Node* Edge::getOpposite(Node *node) {
+Node* Edge::getOpposite(const Node *node) const {
     if (node->equals(n1))
         return n2;
     else if (node->equals(n2))
@@ -17,9 +17,12 @@ public:
 
 protected:
     unsigned int id;///< Identificador único de la arista
+    unsigned int pos1 = 0;///< Posición de la arista en la lista de adyacencia de n1.
     Node *n1;///< Puntero al nodo.
     Node *n2;///< Puntero al nodo opuesto.
     double weight;///< Peso de la arista.
+    unsigned int pos2 = 0;///< Posición de la arista en la lista de adyacencia de n2 (igual a pos1 en un bucle).
+    bool removed = false;///< Marca de arista eliminada pendiente de compactar (ver Network::removeEdges()).
 
 public:
     /**
@@ -35,25 +38,25 @@ public:
      * @brief Devuelve el identificador de la arista.
      * @return El id de la arista.
      */
-    unsigned int getID();
+    unsigned int getID() const;
 
     /**
      * @brief Devuelve el puntero al nodo de origen.
      * @return Puntero al nodo origen.
      */
-    Node* getOrigin();
+    Node* getOrigin() const;
 
     /**
      * @brief Devuelve el puntero al nodo de destino.
      * @return Puntero al nodo destino.
      */
-    Node* getDestiny();
+    Node* getDestiny() const;
 
     /**
      * @brief Devuelve el peso de la arista.
      * @return El valor del peso.
      */
-    double getWeight();
+    double getWeight() const;
 
     /**
      * @brief Dado un nodo que pertenece a la arista, devuelve el nodo opuesto.
@@ -61,7 +64,34 @@ public:
      * @param n Puntero a uno de los nodos de la arista.
      * @return Puntero al nodo opuesto, o nullptr si 'n' no está en el otro extremo de la arista.
      */
-    Node *getOpposite(Node *n);
+    Node *getOpposite(const Node *n) const;
+
+    /**
+     * @brief Devuelve la posición de la arista en la lista de adyacencia de uno de sus nodos.
+     * @param n Puntero a uno de los nodos de la arista.
+     */
+    unsigned int getPosition(Node *n) const { return n == n1 ? pos1 : pos2; }
+
+    /**
+     * @brief Guarda la posición de la arista en la lista de adyacencia de uno de sus nodos.
+     * @details La mantiene Node al añadir, quitar o compactar aristas, para quitarlas en O(1).
+     * @param n Puntero a uno de los nodos de la arista.
+     * @param pos Posición en la lista de adyacencia de 'n'.
+     */
+    void setPosition(Node *n, unsigned int pos) {
+        if (n == n1) pos1 = pos;
+        if (n == n2) pos2 = pos;
+    }
+
+    /**
+     * @brief Indica si la arista está marcada como eliminada (pendiente de compactar las listas).
+     */
+    bool isRemoved() const { return removed; }
+
+    /**
+     * @brief Marca la arista como eliminada; Node::compactEdges() la quita después de las listas.
+     */
+    void markRemoved() { removed = true; }
 
     /**
      * @brief Compara si dos aristas son iguales basándose en su ID.
@@ -0,0 +1,168 @@
+#include "EdgeListParser.h"
+#include <algorithm>
+#include <charconv>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <omp.h>
+
+namespace networkStructure {
+
+namespace {
+
+// Campo de una línea sin espacios ni '\r' en los extremos
+void trim(const char*& first, const char*& last) {
+    while (first < last && (*first == ' ' || *first == '\t')) ++first;
+    while (last > first && (last[-1] == ' ' || last[-1] == '\t' || last[-1] == '\r')) --last;
+}
+
+template <typename T>
+bool parseField(const char* first, const char* last, T& value) {
+    trim(first, last);
+    if (first == last) return false;
+    auto result = std::from_chars(first, last, value);
+    return result.ec == std::errc() && result.ptr == last;
+}
+
+// Resultado de interpretar una línea
+enum class LineStatus { OK, INCOMPLETE, INVALID };
+
+LineStatus parseLine(const char* first, const char* last, EdgeRecord& edge) {
+    const char* comma1 = first;
+    while (comma1 < last && *comma1 != ',') ++comma1;
+    if (comma1 == last) return LineStatus::INCOMPLETE;
+    const char* comma2 = comma1 + 1;
+    while (comma2 < last && *comma2 != ',') ++comma2;
+    if (comma2 == last || comma2 + 1 == last) return LineStatus::INCOMPLETE;
+
+    if (!parseField(first, comma1, edge.origin) ||
+        !parseField(comma1 + 1, comma2, edge.destiny) ||
+        !parseField(comma2 + 1, last, edge.weight)) {
+        return LineStatus::INVALID;
+    }
+    return LineStatus::OK;
+}
+
+} // namespace
+
+bool parseEdgeListCSV(const std::string& filename, std::vector<EdgeRecord>& edges) {
+    return parseEdgeListCSV(filename, edges, 0, 1);
+}
+
+bool parseEdgeListCSV(const std::string& filename, std::vector<EdgeRecord>& edges, int part, int n_parts) {
+    edges.clear();
+    if (n_parts < 1 || part < 0 || part >= n_parts) {
+        std::cerr << "Error: Parte " << part << " de " << n_parts << " no valida." << std::endl;
+        return false;
+    }
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Error: No se pudo abrir el archivo " << filename << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        std::cerr << "Error: No se pudo abrir el archivo " << filename << std::endl;
+        ::close(fd);
+        return false;
+    }
+    std::size_t size = static_cast<std::size_t>(st.st_size);
+    if (size == 0) {
+        ::close(fd);
+        return true;
+    }
+    void* base = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        std::cerr << "Error: No se pudo abrir el archivo " << filename << std::endl;
+        return false;
+    }
+    ::madvise(base, size, MADV_SEQUENTIAL);
+    const char* data = static_cast<const char*>(base);
+    const char* data_end = data + size;
+
+    // Saltamos la cabecera
+    const char* body = data;
+    while (body < data_end && *body != '\n') ++body;
+    if (body < data_end) ++body;
+
+    // Rango de la parte pedida, con las fronteras ajustadas al inicio de línea como las de los hilos
+    auto lineStart = [&](int k) {
+        if (k == 0) return body;
+        if (k == n_parts) return data_end;
+        const char* b = body + static_cast<std::size_t>(data_end - body) * static_cast<std::size_t>(k) /
+                                   static_cast<std::size_t>(n_parts);
+        while (b < data_end && b[-1] != '\n') ++b;
+        return b;
+    };
+    const char* part_begin = lineStart(part);
+    const char* part_end = lineStart(part + 1);
+    body = part_begin;
+    data_end = part_end;
+
+    int P = omp_get_max_threads();
+    if (P < 1) P = 1;
+    std::size_t body_size = static_cast<std::size_t>(data_end - body);
+    if (body_size < static_cast<std::size_t>(P) * 4096) P = 1; // no compensa dividir ficheros pequeños
+
+    // Fronteras de los rangos: cada una avanza hasta el inicio de la siguiente línea
+    std::vector<const char*> bounds(P + 1);
+    bounds[0] = body;
+    bounds[P] = data_end;
+    for (int t = 1; t < P; ++t) {
+        const char* b = body + body_size * static_cast<std::size_t>(t) / static_cast<std::size_t>(P);
+        if (b < bounds[t - 1]) b = bounds[t - 1];
+        while (b < data_end && b[-1] != '\n') ++b;
+        bounds[t] = b;
+    }
+
+    std::vector<std::vector<EdgeRecord>> buffers(P);
+    std::vector<std::vector<std::string>> invalid_lines(P);
+
+    #pragma omp parallel num_threads(P)
+    {
+        int tid = omp_get_thread_num();
+        std::vector<EdgeRecord>& local = buffers[tid];
+        local.reserve(static_cast<std::size_t>(bounds[tid + 1] - bounds[tid]) / 16);
+
+        const char* line = bounds[tid];
+        const char* chunk_end = bounds[tid + 1];
+        while (line < chunk_end) {
+            const char* line_end = line;
+            while (line_end < chunk_end && *line_end != '\n') ++line_end;
+
+            EdgeRecord edge;
+            LineStatus status = parseLine(line, line_end, edge);
+            if (status == LineStatus::OK) {
+                local.push_back(edge);
+            } else if (status == LineStatus::INVALID) {
+                const char* shown_end = (line_end > line && line_end[-1] == '\r') ? line_end - 1 : line_end;
+                invalid_lines[tid].emplace_back(line, shown_end);
+            }
+            line = line_end + 1;
+        }
+    }
+
+    // Avisos en el orden del fichero
+    for (int t = 0; t < P; ++t) {
+        for (const std::string& bad : invalid_lines[t]) {
+            std::cerr << "Advertencia: Se omitió una línea por formato inválido: " << bad << std::endl;
+        }
+    }
+
+    // Concatenación de los buffers en el orden del fichero
+    std::vector<std::size_t> start(P + 1, 0);
+    for (int t = 0; t < P; ++t) start[t + 1] = start[t] + buffers[t].size();
+    edges.resize(start[P]);
+    #pragma omp parallel for num_threads(P)
+    for (int t = 0; t < P; ++t) {
+        std::copy(buffers[t].begin(), buffers[t].end(), edges.begin() + static_cast<std::ptrdiff_t>(start[t]));
+    }
+
+    ::munmap(base, size);
+    return true;
+}
+
+} // namespace networkStructure
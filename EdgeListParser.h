@@ -0,0 +1,51 @@
+#ifndef EDGELISTPARSER_H
+#define EDGELISTPARSER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace networkStructure {
+
+/**
+ * @struct EdgeRecord
+ * @brief Arista leída de un fichero de lista de aristas.
+ * @details Los IDs son los externos del fichero (hasta 64 bits) hasta que IdMap::translate() los sustituye
+ * por índices densos.
+ */
+struct EdgeRecord {
+    std::uint64_t origin;  ///< ID del nodo de origen.
+    std::uint64_t destiny; ///< ID del nodo de destino.
+    double weight;         ///< Peso de la arista.
+};
+
+/**
+ * @brief Lee en paralelo una lista de aristas en CSV (origen,destino,peso), omitiendo la cabecera.
+ * @details El fichero se proyecta en memoria y se divide en tantos rangos de bytes como hilos OpenMP,
+ * ajustando cada frontera al siguiente salto de línea. Cada hilo interpreta su rango con std::from_chars
+ * (sin std::string, std::stringstream ni excepciones) en su propio buffer de aristas, y al final los buffers
+ * se concatenan en el orden del fichero. Las líneas con menos de tres campos se ignoran y las que tienen
+ * campos no numéricos se notifican por std::cerr, igual que en la carga secuencial.
+ * @param filename Nombre del archivo CSV.
+ * @param edges Vector donde se devuelven las aristas, en el orden del fichero.
+ * @return true si la lectura fue exitosa, false si no se pudo abrir el archivo.
+ */
+bool parseEdgeListCSV(const std::string& filename, std::vector<EdgeRecord>& edges);
+
+/**
+ * @brief Lee en paralelo solo una de las n_parts partes de una lista de aristas en CSV.
+ * @details El cuerpo del fichero (sin la cabecera) se divide en n_parts rangos de bytes del mismo tamaño,
+ * ajustando cada frontera al siguiente salto de línea, de modo que las partes 0..n_parts-1 contienen
+ * todas las líneas exactamente una vez. Sirve para que cada proceso de una ejecución distribuida lea
+ * su parte sin cargar el fichero completo.
+ * @param filename Nombre del archivo CSV.
+ * @param edges Vector donde se devuelven las aristas de la parte, en el orden del fichero.
+ * @param part Parte a leer, en [0, n_parts).
+ * @param n_parts Nº de partes.
+ * @return true si la lectura fue exitosa, false si no se pudo abrir el archivo o la parte no es válida.
+ */
+bool parseEdgeListCSV(const std::string& filename, std::vector<EdgeRecord>& edges, int part, int n_parts);
+
+} // namespace networkStructure
+
+#endif // EDGELISTPARSER_H
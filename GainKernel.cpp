@@ -0,0 +1,298 @@
+#include "GainKernel.h"
+
+#include <limits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define GAINKERNEL_X86 1
+#endif
+
+namespace networkStructure {
+
+namespace {
+// Por debajo de este nº de candidatas no compensa entrar en la versión vectorial
+const std::size_t MIN_SIMD_CANDIDATES = 32;
+
+using KernelFn = int (*)(const double*, const double*, const double*, std::size_t, double, double, double&);
+using NeighborFn = int (*)(const int*, std::size_t, int, const double*, const unsigned int*, const double*, double,
+                           double, double&);
+
+KernelFn kernelFor(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::AVX512: return bestCandidateAVX512;
+    case SimdLevel::AVX2:   return bestCandidateAVX2;
+    default:                return bestCandidateScalar;
+    }
+}
+
+NeighborFn neighborKernelFor(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::AVX512: return bestNeighborAVX512;
+    case SimdLevel::AVX2:   return bestNeighborAVX2;
+    default:                return bestNeighborScalar;
+    }
+}
+
+// Reduce los máximos parciales de cada carril al máximo global (a igual valor, el menor índice)
+int reduceLanes(const double* scores, const double* indices, int lanes, double& best_score) {
+    int best = -1;
+    for (int l = 0; l < lanes; ++l) {
+        if (indices[l] < 0.0) continue;
+        int idx = static_cast<int>(indices[l]);
+        if (best == -1 || scores[l] > best_score || (scores[l] == best_score && idx < best)) {
+            best_score = scores[l];
+            best = idx;
+        }
+    }
+    return best;
+}
+
+// Completa con el bucle escalar las candidatas [begin, n) que no llenan un registro
+int scalarTail(const double* w, const double* size, const double* deg, std::size_t begin, std::size_t n,
+               double alpha, double beta, int best, double& best_score) {
+    for (std::size_t i = begin; i < n; ++i) {
+        double score = w[i] - alpha * size[i] - beta * deg[i];
+        if (best == -1 || score > best_score) {
+            best_score = score;
+            best = static_cast<int>(i);
+        }
+    }
+    return best;
+}
+
+// Igual que scalarTail() para bestNeighbor(): 'best' es una posición de 'keys'
+int neighborTail(const int* keys, std::size_t begin, std::size_t n, int exclude, const double* w,
+                 const unsigned int* size, const double* deg, double alpha, double beta, int best, double& best_score) {
+    for (std::size_t i = begin; i < n; ++i) {
+        int c = keys[i];
+        if (c == exclude) continue;
+        double score = w[c] - alpha * static_cast<double>(size[c]) - beta * deg[c];
+        if (best == -1 || score > best_score) {
+            best_score = score;
+            best = static_cast<int>(i);
+        }
+    }
+    return best;
+}
+} // namespace
+
+int CandidateBuffer::best(const LinearGain& gain, double& best_gain) const {
+    double score = 0.0;
+    int idx = bestCandidate(weights.data(), sizes.data(), degrees.data(), communities.size(), gain.alpha, gain.beta,
+                            score);
+    if (idx < 0) return -1;
+    best_gain = score + gain.offset;
+    return communities[idx];
+}
+
+int bestCandidateScalar(const double* w, const double* size, const double* deg, std::size_t n, double alpha,
+                        double beta, double& best_score) {
+    return scalarTail(w, size, deg, 0, n, alpha, beta, -1, best_score);
+}
+
+int bestNeighborScalar(const int* keys, std::size_t n, int exclude, const double* w, const unsigned int* size,
+                       const double* deg, double alpha, double beta, double& best_score) {
+    int best = neighborTail(keys, 0, n, exclude, w, size, deg, alpha, beta, -1, best_score);
+    return best == -1 ? -1 : keys[best];
+}
+
+#ifdef GAINKERNEL_X86
+// GCC avisa de registros sin inicializar dentro de las propias intrínsecas (usan _mm*_undefined_*)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+__attribute__((target("avx2")))
+int bestCandidateAVX2(const double* w, const double* size, const double* deg, std::size_t n, double alpha,
+                      double beta, double& best_score) {
+    if (n < 4) return bestCandidateScalar(w, size, deg, n, alpha, beta, best_score);
+    const __m256d va = _mm256_set1_pd(alpha);
+    const __m256d vb = _mm256_set1_pd(beta);
+    const __m256d step = _mm256_set1_pd(4.0);
+    __m256d best = _mm256_set1_pd(-std::numeric_limits<double>::infinity());
+    __m256d best_idx = _mm256_set1_pd(-1.0);
+    __m256d idx = _mm256_set_pd(3.0, 2.0, 1.0, 0.0);
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d score = _mm256_sub_pd(_mm256_sub_pd(_mm256_loadu_pd(w + i), _mm256_mul_pd(va, _mm256_loadu_pd(size + i))),
+                                      _mm256_mul_pd(vb, _mm256_loadu_pd(deg + i)));
+        // Comparación estricta: en cada carril se conserva el primer máximo
+        __m256d greater = _mm256_cmp_pd(score, best, _CMP_GT_OQ);
+        best = _mm256_blendv_pd(best, score, greater);
+        best_idx = _mm256_blendv_pd(best_idx, idx, greater);
+        idx = _mm256_add_pd(idx, step);
+    }
+    alignas(32) double scores[4];
+    alignas(32) double indices[4];
+    _mm256_store_pd(scores, best);
+    _mm256_store_pd(indices, best_idx);
+    int result = reduceLanes(scores, indices, 4, best_score);
+    return scalarTail(w, size, deg, i, n, alpha, beta, result, best_score);
+}
+
+__attribute__((target("avx512f")))
+int bestCandidateAVX512(const double* w, const double* size, const double* deg, std::size_t n, double alpha,
+                        double beta, double& best_score) {
+    if (n < 8) return bestCandidateScalar(w, size, deg, n, alpha, beta, best_score);
+    const __m512d va = _mm512_set1_pd(alpha);
+    const __m512d vb = _mm512_set1_pd(beta);
+    const __m512d step = _mm512_set1_pd(8.0);
+    __m512d best = _mm512_set1_pd(-std::numeric_limits<double>::infinity());
+    __m512d best_idx = _mm512_set1_pd(-1.0);
+    __m512d idx = _mm512_set_pd(7.0, 6.0, 5.0, 4.0, 3.0, 2.0, 1.0, 0.0);
+
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d score = _mm512_sub_pd(_mm512_sub_pd(_mm512_loadu_pd(w + i), _mm512_mul_pd(va, _mm512_loadu_pd(size + i))),
+                                      _mm512_mul_pd(vb, _mm512_loadu_pd(deg + i)));
+        __mmask8 greater = _mm512_cmp_pd_mask(score, best, _CMP_GT_OQ);
+        best = _mm512_mask_blend_pd(greater, best, score);
+        best_idx = _mm512_mask_blend_pd(greater, best_idx, idx);
+        idx = _mm512_add_pd(idx, step);
+    }
+    alignas(64) double scores[8];
+    alignas(64) double indices[8];
+    _mm512_store_pd(scores, best);
+    _mm512_store_pd(indices, best_idx);
+    int result = reduceLanes(scores, indices, 8, best_score);
+    return scalarTail(w, size, deg, i, n, alpha, beta, result, best_score);
+}
+
+__attribute__((target("avx2")))
+int bestNeighborAVX2(const int* keys, std::size_t n, int exclude, const double* w, const unsigned int* size,
+                     const double* deg, double alpha, double beta, double& best_score) {
+    if (n < 4) return bestNeighborScalar(keys, n, exclude, w, size, deg, alpha, beta, best_score);
+    const __m256d va = _mm256_set1_pd(alpha);
+    const __m256d vb = _mm256_set1_pd(beta);
+    const __m256d step = _mm256_set1_pd(4.0);
+    const __m256d minus_inf = _mm256_set1_pd(-std::numeric_limits<double>::infinity());
+    const __m128i vexclude = _mm_set1_epi32(exclude);
+    __m256d best = minus_inf;
+    __m256d best_idx = _mm256_set1_pd(-1.0);
+    __m256d idx = _mm256_set_pd(3.0, 2.0, 1.0, 0.0);
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i vkeys = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i));
+        // Los tamaños caben en un int con signo (como mucho el nº de nodos)
+        __m256d vsize = _mm256_cvtepi32_pd(_mm_i32gather_epi32(reinterpret_cast<const int*>(size), vkeys, 4));
+        __m256d score = _mm256_sub_pd(_mm256_sub_pd(_mm256_i32gather_pd(w, vkeys, 8), _mm256_mul_pd(va, vsize)),
+                                      _mm256_mul_pd(vb, _mm256_i32gather_pd(deg, vkeys, 8)));
+        // La comunidad excluida nunca gana
+        __m256d excluded = _mm256_castsi256_pd(_mm256_cvtepi32_epi64(_mm_cmpeq_epi32(vkeys, vexclude)));
+        score = _mm256_blendv_pd(score, minus_inf, excluded);
+        __m256d greater = _mm256_cmp_pd(score, best, _CMP_GT_OQ);
+        best = _mm256_blendv_pd(best, score, greater);
+        best_idx = _mm256_blendv_pd(best_idx, idx, greater);
+        idx = _mm256_add_pd(idx, step);
+    }
+    alignas(32) double scores[4];
+    alignas(32) double indices[4];
+    _mm256_store_pd(scores, best);
+    _mm256_store_pd(indices, best_idx);
+    int result = reduceLanes(scores, indices, 4, best_score);
+    result = neighborTail(keys, i, n, exclude, w, size, deg, alpha, beta, result, best_score);
+    return result == -1 ? -1 : keys[result];
+}
+
+__attribute__((target("avx512f,avx2")))
+int bestNeighborAVX512(const int* keys, std::size_t n, int exclude, const double* w, const unsigned int* size,
+                       const double* deg, double alpha, double beta, double& best_score) {
+    if (n < 8) return bestNeighborScalar(keys, n, exclude, w, size, deg, alpha, beta, best_score);
+    const __m512d va = _mm512_set1_pd(alpha);
+    const __m512d vb = _mm512_set1_pd(beta);
+    const __m512d step = _mm512_set1_pd(8.0);
+    const __m512i vexclude = _mm512_set1_epi64(exclude);
+    __m512d best = _mm512_set1_pd(-std::numeric_limits<double>::infinity());
+    __m512d best_idx = _mm512_set1_pd(-1.0);
+    __m512d idx = _mm512_set_pd(7.0, 6.0, 5.0, 4.0, 3.0, 2.0, 1.0, 0.0);
+
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i vkeys = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i));
+        __m512d vsize = _mm512_cvtepi32_pd(_mm256_i32gather_epi32(reinterpret_cast<const int*>(size), vkeys, 4));
+        __m512d score = _mm512_sub_pd(_mm512_sub_pd(_mm512_i32gather_pd(vkeys, w, 8), _mm512_mul_pd(va, vsize)),
+                                      _mm512_mul_pd(vb, _mm512_i32gather_pd(vkeys, deg, 8)));
+        // Solo compiten los carriles que no son la comunidad excluida
+        __mmask8 valid = _mm512_cmpneq_epi64_mask(_mm512_cvtepi32_epi64(vkeys), vexclude);
+        __mmask8 greater = _mm512_mask_cmp_pd_mask(valid, score, best, _CMP_GT_OQ);
+        best = _mm512_mask_blend_pd(greater, best, score);
+        best_idx = _mm512_mask_blend_pd(greater, best_idx, idx);
+        idx = _mm512_add_pd(idx, step);
+    }
+    alignas(64) double scores[8];
+    alignas(64) double indices[8];
+    _mm512_store_pd(scores, best);
+    _mm512_store_pd(indices, best_idx);
+    int result = reduceLanes(scores, indices, 8, best_score);
+    result = neighborTail(keys, i, n, exclude, w, size, deg, alpha, beta, result, best_score);
+    return result == -1 ? -1 : keys[result];
+}
+
+#pragma GCC diagnostic pop
+
+bool isSimdLevelSupported(SimdLevel level) {
+    __builtin_cpu_init();
+    switch (level) {
+    case SimdLevel::AVX512: return __builtin_cpu_supports("avx512f");
+    case SimdLevel::AVX2:   return __builtin_cpu_supports("avx2");
+    default:                return true;
+    }
+}
+#else
+int bestCandidateAVX2(const double* w, const double* size, const double* deg, std::size_t n, double alpha,
+                      double beta, double& best_score) {
+    return bestCandidateScalar(w, size, deg, n, alpha, beta, best_score);
+}
+
+int bestCandidateAVX512(const double* w, const double* size, const double* deg, std::size_t n, double alpha,
+                        double beta, double& best_score) {
+    return bestCandidateScalar(w, size, deg, n, alpha, beta, best_score);
+}
+
+int bestNeighborAVX2(const int* keys, std::size_t n, int exclude, const double* w, const unsigned int* size,
+                     const double* deg, double alpha, double beta, double& best_score) {
+    return bestNeighborScalar(keys, n, exclude, w, size, deg, alpha, beta, best_score);
+}
+
+int bestNeighborAVX512(const int* keys, std::size_t n, int exclude, const double* w, const unsigned int* size,
+                       const double* deg, double alpha, double beta, double& best_score) {
+    return bestNeighborScalar(keys, n, exclude, w, size, deg, alpha, beta, best_score);
+}
+
+bool isSimdLevelSupported(SimdLevel level) {
+    return level == SimdLevel::SCALAR;
+}
+#endif
+
+SimdLevel getSimdLevel() {
+    // Se detecta una sola vez (inicialización de estático local, segura entre hilos)
+    static const SimdLevel level = isSimdLevelSupported(SimdLevel::AVX512) ? SimdLevel::AVX512
+                                 : isSimdLevelSupported(SimdLevel::AVX2)   ? SimdLevel::AVX2
+                                                                           : SimdLevel::SCALAR;
+    return level;
+}
+
+int bestCandidate(const double* w, const double* size, const double* deg, std::size_t n, double alpha, double beta,
+                  double& best_score) {
+    if (n < MIN_SIMD_CANDIDATES) return bestCandidateScalar(w, size, deg, n, alpha, beta, best_score);
+    static const KernelFn kernel = kernelFor(getSimdLevel());
+    return kernel(w, size, deg, n, alpha, beta, best_score);
+}
+
+int bestNeighbor(const int* keys, std::size_t n, int exclude, const double* w, const unsigned int* size,
+                 const double* deg, double alpha, double beta, double& best_score) {
+    if (n < MIN_SIMD_CANDIDATES) return bestNeighborScalar(keys, n, exclude, w, size, deg, alpha, beta, best_score);
+    static const NeighborFn kernel = neighborKernelFor(getSimdLevel());
+    return kernel(keys, n, exclude, w, size, deg, alpha, beta, best_score);
+}
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::AVX512: return "avx512";
+    case SimdLevel::AVX2:   return "avx2";
+    default:                return "scalar";
+    }
+}
+
+} // namespace networkStructure
@@ -0,0 +1,157 @@
+#ifndef GAINKERNEL_H
+#define GAINKERNEL_H
+
+#include <vector>
+#include <cstddef>
+
+namespace networkStructure {
+
+/**
+ * @struct LinearGain
+ * @brief Ganancia de mover un nodo a cada comunidad candidata j, expresada como función lineal de los datos
+ * de j: ΔQ_j = w_j - alpha * size_j - beta * tot_j + offset.
+ * @details w_j es el peso de las aristas del nodo hacia j, size_j su tamaño y tot_j su grado total. alpha,
+ * beta y offset solo dependen del nodo y de su comunidad actual (ver CPMQuality::linearGain()), así que
+ * el mejor destino se obtiene con una única reducción sobre arrays contiguos.
+ */
+struct LinearGain {
+    double alpha = 0.0;  ///< Coeficiente del tamaño de la comunidad destino.
+    double beta = 0.0;   ///< Coeficiente del grado total de la comunidad destino.
+    double offset = 0.0; ///< Término común a todos los destinos.
+};
+
+/**
+ * @enum SimdLevel
+ * @brief Conjunto de instrucciones usado por bestCandidate().
+ */
+enum class SimdLevel {
+    SCALAR, ///< Bucle escalar (sin extensiones vectoriales o fuera de x86).
+    AVX2,   ///< 4 doubles por instrucción.
+    AVX512  ///< 8 doubles por instrucción.
+};
+
+/**
+ * @class CandidateBuffer
+ * @brief Comunidades candidatas de un nodo con sus datos en arrays contiguos (estructura de arrays).
+ * @details Se rellena a partir del acumulador de pesos por comunidad vecina y se evalúa de una vez con
+ * best(). Como NeighborAccumulator, se reserva una vez y se reutiliza entre nodos; cada hilo debe usar su
+ * propia instancia.
+ */
+class CandidateBuffer {
+private:
+    std::vector<int> communities; ///< ID de cada comunidad candidata.
+    std::vector<double> weights;  ///< Peso de las aristas del nodo hacia cada candidata.
+    std::vector<double> sizes;    ///< Tamaño de cada candidata.
+    std::vector<double> degrees;  ///< Grado total de cada candidata.
+
+public:
+    /**
+     * @brief Vacía el buffer sin liberar memoria.
+     */
+    void clear() {
+        communities.clear();
+        weights.clear();
+        sizes.clear();
+        degrees.clear();
+    }
+
+    /**
+     * @brief Añade una comunidad candidata.
+     */
+    void add(int comm, double weight, double size, double degree) {
+        communities.push_back(comm);
+        weights.push_back(weight);
+        sizes.push_back(size);
+        degrees.push_back(degree);
+    }
+
+    /**
+     * @brief Nº de candidatas.
+     */
+    std::size_t size() const { return communities.size(); }
+
+    /**
+     * @brief Busca la candidata con mayor ganancia.
+     * @param gain Coeficientes de la ganancia del nodo.
+     * @param best_gain Salida: ganancia de la mejor candidata (incluido gain.offset).
+     * @return ID de la mejor comunidad (la primera en caso de empate), o -1 si no hay candidatas.
+     */
+    int best(const LinearGain& gain, double& best_gain) const;
+};
+
+/**
+ * @brief Índice del máximo de w[i] - alpha * size[i] - beta * deg[i] (el primero en caso de empate).
+ * @details Usa la versión vectorial disponible en la CPU (AVX-512, AVX2 o escalar), elegida una sola vez en
+ * tiempo de ejecución. Todas las versiones hacen las mismas operaciones en el mismo orden y con el mismo
+ * desempate, así que eligen la misma candidata salvo diferencias de redondeo.
+ * @param w Pesos hacia cada candidata.
+ * @param size Tamaño de cada candidata.
+ * @param deg Grado total de cada candidata.
+ * @param n Nº de candidatas.
+ * @param alpha Coeficiente del tamaño.
+ * @param beta Coeficiente del grado total.
+ * @param best_score Salida: valor máximo (sin offset).
+ * @return Índice del máximo, o -1 si n == 0.
+ */
+int bestCandidate(const double* w, const double* size, const double* deg, std::size_t n, double alpha, double beta,
+                  double& best_score);
+
+/**
+ * @brief Versiones concretas de bestCandidate(), para pruebas y benchmarks. Las vectoriales solo pueden
+ * llamarse si la CPU las soporta (ver isSimdLevelSupported()).
+ */
+int bestCandidateScalar(const double* w, const double* size, const double* deg, std::size_t n, double alpha,
+                        double beta, double& best_score);
+int bestCandidateAVX2(const double* w, const double* size, const double* deg, std::size_t n, double alpha,
+                      double beta, double& best_score);
+int bestCandidateAVX512(const double* w, const double* size, const double* deg, std::size_t n, double alpha,
+                        double beta, double& best_score);
+
+/**
+ * @brief Mejor comunidad vecina de un nodo leyendo sus datos directamente de los arrays densos por comunidad.
+ * @details Igual que bestCandidate(), pero sin copiar antes las candidatas: para cada clave c de 'keys' (salvo
+ * 'exclude') calcula w[c] - alpha * size[c] - beta * deg[c] con cargas indexadas (gather) y devuelve la de
+ * mayor valor (la primera en caso de empate). Es la búsqueda que usa el movimiento local cuando los datos de
+ * las comunidades están en un CommunityState y los pesos en un NeighborAccumulator.
+ * @param keys Comunidades vecinas (NeighborAccumulator::getKeys()).
+ * @param n Nº de comunidades vecinas.
+ * @param exclude Comunidad que no se considera (la actual del nodo).
+ * @param w Pesos hacia cada comunidad, indexados por ID (NeighborAccumulator::getWeights()).
+ * @param size Tamaño de cada comunidad, indexado por ID (CommunityState::getSizes()).
+ * @param deg Grado total de cada comunidad, indexado por ID (CommunityState::getTotalDegrees()).
+ * @param alpha Coeficiente del tamaño.
+ * @param beta Coeficiente del grado total.
+ * @param best_score Salida: valor máximo (sin offset).
+ * @return ID de la mejor comunidad, o -1 si no hay ninguna distinta de 'exclude'.
+ */
+int bestNeighbor(const int* keys, std::size_t n, int exclude, const double* w, const unsigned int* size,
+                 const double* deg, double alpha, double beta, double& best_score);
+
+/**
+ * @brief Versiones concretas de bestNeighbor(), para pruebas y benchmarks.
+ */
+int bestNeighborScalar(const int* keys, std::size_t n, int exclude, const double* w, const unsigned int* size,
+                       const double* deg, double alpha, double beta, double& best_score);
+int bestNeighborAVX2(const int* keys, std::size_t n, int exclude, const double* w, const unsigned int* size,
+                     const double* deg, double alpha, double beta, double& best_score);
+int bestNeighborAVX512(const int* keys, std::size_t n, int exclude, const double* w, const unsigned int* size,
+                       const double* deg, double alpha, double beta, double& best_score);
+
+/**
+ * @brief Nivel vectorial que usan bestCandidate() y bestNeighbor() en esta CPU.
+ */
+SimdLevel getSimdLevel();
+
+/**
+ * @brief Indica si la CPU soporta un nivel vectorial.
+ */
+bool isSimdLevelSupported(SimdLevel level);
+
+/**
+ * @brief Nombre de un nivel vectorial ("scalar", "avx2" o "avx512").
+ */
+const char* simdLevelName(SimdLevel level);
+
+} // namespace networkStructure
+
+#endif // GAINKERNEL_H
@@ -0,0 +1,312 @@
+#include "GraphGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace networkStructure {
+
+namespace {
+/**
+ * @brief Recorre los pares de un conjunto de 'total' pares que salen con probabilidad p, saltando de uno a
+ * otro con una distribución geométrica (O(nº de aristas) en lugar de O(total)).
+ * @param emit Recibe el índice lineal de cada par elegido.
+ */
+template <class Emit>
+void samplePairs(std::uint64_t total, double p, std::mt19937_64& rng, Emit emit) {
+    if (p <= 0.0 || total == 0) return;
+    if (p >= 1.0) {
+        for (std::uint64_t k = 0; k < total; ++k) emit(k);
+        return;
+    }
+    std::geometric_distribution<std::uint64_t> skip(p);
+    for (std::uint64_t k = skip(rng); k < total; k += 1 + skip(rng)) {
+        emit(k);
+    }
+}
+
+/**
+ * @brief Pares (u, v) con u < v de los nodos first..first+size-1, cada uno con probabilidad p.
+ */
+void sampleTriangle(unsigned int first, unsigned int size, double p, std::mt19937_64& rng,
+                    std::vector<EdgeRecord>& edges) {
+    std::uint64_t s = size;
+    // El par k es el (v, w) con w < v de la fila v, que empieza en v (v - 1) / 2
+    std::uint64_t v = 1;
+    samplePairs(s * (s - 1) / 2, p, rng, [&](std::uint64_t k) {
+        while (v * (v + 1) / 2 <= k) ++v;
+        std::uint64_t w = k - v * (v - 1) / 2;
+        edges.push_back({first + w, first + v, 1.0});
+    });
+}
+
+/**
+ * @brief Pares (u, v) con u en el bloque a y v en el bloque b, cada uno con probabilidad p.
+ */
+void sampleRectangle(unsigned int first_a, unsigned int size_a, unsigned int first_b, unsigned int size_b, double p,
+                     std::mt19937_64& rng, std::vector<EdgeRecord>& edges) {
+    samplePairs(static_cast<std::uint64_t>(size_a) * size_b, p, rng, [&](std::uint64_t k) {
+        edges.push_back({first_a + k / size_b, first_b + k % size_b, 1.0});
+    });
+}
+
+/**
+ * @brief Valor de una ley de potencias continua de exponente tau en [x_min, x_max] (inversa de la CDF).
+ */
+double samplePowerLaw(double x_min, double x_max, double tau, std::mt19937_64& rng) {
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    double u = uniform(rng);
+    if (std::abs(tau - 1.0) < 1e-9) {
+        return x_min * std::pow(x_max / x_min, u);
+    }
+    double a = std::pow(x_min, 1.0 - tau);
+    double b = std::pow(x_max, 1.0 - tau);
+    return std::pow(a + (b - a) * u, 1.0 / (1.0 - tau));
+}
+
+/**
+ * @brief Media de la ley de potencias continua de exponente tau en [x_min, x_max].
+ */
+double powerLawMean(double x_min, double x_max, double tau) {
+    if (x_max <= x_min) return x_min;
+    auto integral = [](double x_lo, double x_hi, double e) { // ∫ x^-e dx
+        if (std::abs(e - 1.0) < 1e-9) return std::log(x_hi / x_lo);
+        return (std::pow(x_hi, 1.0 - e) - std::pow(x_lo, 1.0 - e)) / (1.0 - e);
+    };
+    return integral(x_min, x_max, tau - 1.0) / integral(x_min, x_max, tau);
+}
+
+/**
+ * @brief Clave única de la arista no dirigida (u, v).
+ */
+std::uint64_t edgeKey(unsigned int u, unsigned int v) {
+    if (u > v) std::swap(u, v);
+    return (static_cast<std::uint64_t>(u) << 32) | v;
+}
+
+/**
+ * @brief Empareja al azar los extremos de 'stubs' y añade las aristas válidas.
+ * @details Se descartan los bucles, las aristas ya existentes y (con 'community' no vacío) las que unen
+ * nodos de la misma comunidad. Los extremos rechazados se vuelven a barajar unas pocas veces.
+ */
+void wireStubs(std::vector<unsigned int>& stubs, const std::vector<int>& community, std::mt19937_64& rng,
+               std::unordered_set<std::uint64_t>& existing, std::vector<EdgeRecord>& edges) {
+    const int max_rounds = 4;
+    for (int round = 0; round < max_rounds && stubs.size() >= 2; ++round) {
+        std::shuffle(stubs.begin(), stubs.end(), rng);
+        std::vector<unsigned int> rejected;
+        for (std::size_t k = 0; k + 1 < stubs.size(); k += 2) {
+            unsigned int u = stubs[k];
+            unsigned int v = stubs[k + 1];
+            bool valid = u != v && (community.empty() || community[u] != community[v]);
+            if (valid && existing.insert(edgeKey(u, v)).second) {
+                edges.push_back({u, v, 1.0});
+            } else {
+                rejected.push_back(u);
+                rejected.push_back(v);
+            }
+        }
+        stubs.swap(rejected);
+    }
+}
+} // namespace
+
+GeneratedGraph generateSBM(unsigned int n_blocks, unsigned int block_size, double p_in, double p_out,
+                           unsigned int seed) {
+    GeneratedGraph graph;
+    std::mt19937_64 rng(seed);
+    graph.ground_truth.resize(static_cast<std::size_t>(n_blocks) * block_size);
+    for (unsigned int b = 0; b < n_blocks; ++b) {
+        unsigned int first = b * block_size;
+        std::fill(graph.ground_truth.begin() + first, graph.ground_truth.begin() + first + block_size,
+                  static_cast<int>(b));
+        sampleTriangle(first, block_size, p_in, rng, graph.edges);
+        for (unsigned int c = b + 1; c < n_blocks; ++c) {
+            sampleRectangle(first, block_size, c * block_size, block_size, p_out, rng, graph.edges);
+        }
+    }
+    return graph;
+}
+
+GeneratedGraph generateLFR(unsigned int n, double avg_degree, unsigned int max_degree, double mu,
+                           unsigned int min_comm, unsigned int max_comm, unsigned int seed, double tau1,
+                           double tau2) {
+    GeneratedGraph graph;
+    if (n == 0) return graph;
+    std::mt19937_64 rng(seed);
+    if (max_comm > n) max_comm = n;
+    if (min_comm < 1) min_comm = 1;
+    if (min_comm > max_comm) min_comm = max_comm;
+
+    // Grado mínimo para que la media de la ley de potencias sea avg_degree (bisección)
+    double k_max = static_cast<double>(std::max(1u, max_degree));
+    double lo = 1.0, hi = k_max;
+    for (int it = 0; it < 60; ++it) {
+        double mid = 0.5 * (lo + hi);
+        if (powerLawMean(mid, k_max, tau1) < avg_degree) lo = mid; else hi = mid;
+    }
+    std::vector<unsigned int> degree(n);
+    for (unsigned int& k : degree) {
+        k = static_cast<unsigned int>(std::lround(samplePowerLaw(lo, k_max, tau1, rng)));
+        if (k < 1) k = 1;
+    }
+
+    // Tamaños de comunidad hasta cubrir los n nodos; el sobrante que no llega a min_comm se reparte
+    std::vector<unsigned int> sizes;
+    unsigned int covered = 0;
+    while (covered < n) {
+        unsigned int s = static_cast<unsigned int>(
+            std::lround(samplePowerLaw(min_comm, std::max<double>(min_comm, max_comm), tau2, rng)));
+        s = std::min(std::max(s, min_comm), n - covered);
+        if (s < min_comm && !sizes.empty()) {
+            for (unsigned int k = 0; k < s; ++k) ++sizes[k % sizes.size()];
+        } else {
+            sizes.push_back(s);
+        }
+        covered += s;
+    }
+    unsigned int largest = *std::max_element(sizes.begin(), sizes.end());
+
+    // Grado interno de cada nodo; debe caber en su comunidad (como mucho tamaño - 1)
+    std::vector<unsigned int> internal(n);
+    for (unsigned int i = 0; i < n; ++i) {
+        internal[i] = static_cast<unsigned int>(std::lround((1.0 - mu) * degree[i]));
+        internal[i] = std::min(internal[i], largest - 1);
+    }
+
+    // Asignación: primero los nodos de mayor grado interno, a una comunidad al azar en la que quepan
+    std::vector<unsigned int> order(n);
+    for (unsigned int i = 0; i < n; ++i) order[i] = i;
+    std::shuffle(order.begin(), order.end(), rng);
+    std::stable_sort(order.begin(), order.end(), [&](unsigned int a, unsigned int b) { return internal[a] > internal[b]; });
+    std::vector<unsigned int> free_slots = sizes;
+    std::vector<int> open; // comunidades con plazas libres
+    for (std::size_t c = 0; c < sizes.size(); ++c) open.push_back(static_cast<int>(c));
+    graph.ground_truth.assign(n, -1);
+    const int max_tries = 16;
+    for (unsigned int i : order) {
+        std::uniform_int_distribution<std::size_t> pick(0, open.size() - 1);
+        std::size_t slot = open.size();
+        for (int t = 0; t < max_tries; ++t) {
+            std::size_t k = pick(rng);
+            if (sizes[open[k]] > internal[i]) {
+                slot = k;
+                break;
+            }
+        }
+        if (slot == open.size()) { // ninguna al azar: la mayor con plazas libres
+            slot = 0;
+            for (std::size_t k = 1; k < open.size(); ++k) {
+                if (sizes[open[k]] > sizes[open[slot]]) slot = k;
+            }
+            internal[i] = std::min(internal[i], sizes[open[slot]] - 1);
+        }
+        int c = open[slot];
+        graph.ground_truth[i] = c;
+        if (--free_slots[c] == 0) {
+            open[slot] = open.back();
+            open.pop_back();
+        }
+    }
+
+    // Emparejamiento de los extremos internos de cada comunidad y de los externos entre comunidades
+    std::vector<std::vector<unsigned int>> internal_stubs(sizes.size());
+    std::vector<unsigned int> external_stubs;
+    for (unsigned int i = 0; i < n; ++i) {
+        internal_stubs[graph.ground_truth[i]].insert(internal_stubs[graph.ground_truth[i]].end(), internal[i], i);
+        unsigned int external = degree[i] > internal[i] ? degree[i] - internal[i] : 0;
+        external_stubs.insert(external_stubs.end(), external, i);
+    }
+    std::unordered_set<std::uint64_t> existing;
+    const std::vector<int> no_communities;
+    for (std::vector<unsigned int>& stubs : internal_stubs) {
+        wireStubs(stubs, no_communities, rng, existing, graph.edges);
+    }
+    wireStubs(external_stubs, graph.ground_truth, rng, existing, graph.edges);
+    return graph;
+}
+
+GeneratedGraph generateErdosRenyi(unsigned int n, double p, unsigned int seed) {
+    GeneratedGraph graph;
+    std::mt19937_64 rng(seed);
+    graph.ground_truth.assign(n, 0);
+    sampleTriangle(0, n, p, rng, graph.edges);
+    return graph;
+}
+
+GeneratedGraph generateRingOfCliques(unsigned int n_cliques, unsigned int clique_size) {
+    GeneratedGraph graph;
+    graph.ground_truth.resize(static_cast<std::size_t>(n_cliques) * clique_size);
+    for (unsigned int c = 0; c < n_cliques; ++c) {
+        unsigned int first = c * clique_size;
+        for (unsigned int u = 0; u < clique_size; ++u) {
+            graph.ground_truth[first + u] = static_cast<int>(c);
+            for (unsigned int v = u + 1; v < clique_size; ++v) {
+                graph.edges.push_back({first + u, first + v, 1.0});
+            }
+        }
+        if (n_cliques >= 2 && clique_size > 0) { // último nodo de la clique -> primero de la siguiente
+            graph.edges.push_back({first + clique_size - 1, ((c + 1) % n_cliques) * clique_size, 1.0});
+        }
+    }
+    return graph;
+}
+
+bool writeEdgeListCSV(const std::string& filename, const std::vector<EdgeRecord>& edges) {
+    std::ofstream out(filename, std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "Error: No se pudo crear el archivo " << filename << std::endl;
+        return false;
+    }
+    out << "origin,destiny,weight\n";
+    for (const EdgeRecord& e : edges) {
+        out << e.origin << ',' << e.destiny << ',' << e.weight << '\n';
+    }
+    out.flush();
+    if (!out) {
+        std::cerr << "Error: Fallo al escribir el archivo " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+double normalizedMutualInformation(const std::vector<int>& a, const std::vector<int>& b) {
+    std::unordered_map<int, double> count_a, count_b;
+    std::unordered_map<std::uint64_t, double> joint;
+    double total = 0.0;
+    std::size_t n = std::min(a.size(), b.size());
+    for (std::size_t i = 0; i < n; ++i) {
+        if (a[i] < 0 || b[i] < 0) continue;
+        count_a[a[i]] += 1.0;
+        count_b[b[i]] += 1.0;
+        joint[(static_cast<std::uint64_t>(a[i]) << 32) | static_cast<std::uint32_t>(b[i])] += 1.0;
+        total += 1.0;
+    }
+    if (total == 0.0) return 0.0;
+    auto entropy = [total](const std::unordered_map<int, double>& counts) {
+        double h = 0.0;
+        for (const auto& entry : counts) {
+            double p = entry.second / total;
+            h -= p * std::log(p);
+        }
+        return h;
+    };
+    double h_a = entropy(count_a);
+    double h_b = entropy(count_b);
+    if (h_a + h_b == 0.0) return 1.0; // ambas con una sola comunidad
+    double mutual = 0.0;
+    for (const auto& entry : joint) {
+        int ca = static_cast<int>(entry.first >> 32);
+        int cb = static_cast<int>(entry.first & 0xffffffffu);
+        double p = entry.second / total;
+        mutual += p * std::log(p * total * total / (count_a[ca] * count_b[cb]));
+    }
+    return std::max(0.0, std::min(1.0, 2.0 * mutual / (h_a + h_b)));
+}
+
+} // namespace networkStructure
@@ -0,0 +1,99 @@
+#ifndef GRAPHGENERATOR_H
+#define GRAPHGENERATOR_H
+
+#include "EdgeListParser.h"
+
+#include <string>
+#include <vector>
+
+namespace networkStructure {
+
+/**
+ * @struct GeneratedGraph
+ * @brief Red sintética con su partición de referencia.
+ * @details Los nodos se numeran 0..n-1 y las aristas usan esos mismos IDs, así que la lista puede insertarse
+ * directamente en una Network o escribirse como CSV con writeEdgeListCSV(). Todas las aristas tienen peso 1,
+ * no hay bucles ni aristas repetidas, y puede haber nodos aislados (que no aparecen en ninguna arista).
+ */
+struct GeneratedGraph {
+    std::vector<EdgeRecord> edges;  ///< Aristas (cada par de nodos una sola vez).
+    std::vector<int> ground_truth;  ///< Comunidad de referencia de cada nodo (0..k-1).
+};
+
+/**
+ * @brief Modelo de bloques estocástico (SBM) con bloques del mismo tamaño.
+ * @details Cada par de nodos del mismo bloque se une con probabilidad p_in y cada par de bloques distintos
+ * con probabilidad p_out. Los pares se recorren saltando directamente a la siguiente arista con una
+ * distribución geométrica, así que el coste es O(n + m) y no O(n^2).
+ * @param n_blocks Nº de bloques (comunidades de referencia).
+ * @param block_size Nº de nodos de cada bloque.
+ * @param p_in Probabilidad de arista dentro de un bloque.
+ * @param p_out Probabilidad de arista entre bloques.
+ * @param seed Semilla (la misma semilla da la misma red con la misma biblioteca estándar).
+ */
+GeneratedGraph generateSBM(unsigned int n_blocks, unsigned int block_size, double p_in, double p_out,
+                           unsigned int seed);
+
+/**
+ * @brief Red con grados y tamaños de comunidad en ley de potencias, al estilo del benchmark LFR.
+ * @details Los grados siguen una ley de potencias de exponente tau1 en [k_min, max_degree], con k_min
+ * ajustado para que el grado medio sea avg_degree, y los tamaños de comunidad otra de exponente tau2 en
+ * [min_comm, max_comm]. Cada nodo va a una comunidad en la que quepa su grado interno (1 - mu) * k y sus
+ * extremos se emparejan al azar (modelo de configuración): los internos dentro de la comunidad y los
+ * externos entre comunidades distintas. Los bucles y las aristas repetidas se descartan, así que los grados
+ * finales pueden quedar algo por debajo de los sorteados. A diferencia del LFR original no se recablea
+ * para corregirlo.
+ * @param n Nº de nodos.
+ * @param avg_degree Grado medio deseado.
+ * @param max_degree Grado máximo.
+ * @param mu Fracción de aristas de cada nodo hacia otras comunidades (parámetro de mezcla).
+ * @param min_comm Tamaño mínimo de comunidad.
+ * @param max_comm Tamaño máximo de comunidad.
+ * @param seed Semilla.
+ * @param tau1 Exponente de la distribución de grados.
+ * @param tau2 Exponente de la distribución de tamaños de comunidad.
+ */
+GeneratedGraph generateLFR(unsigned int n, double avg_degree, unsigned int max_degree, double mu,
+                           unsigned int min_comm, unsigned int max_comm, unsigned int seed, double tau1 = 2.5,
+                           double tau2 = 1.5);
+
+/**
+ * @brief Grafo aleatorio de Erdős-Rényi G(n, p).
+ * @details No tiene estructura de comunidades: la referencia es una sola comunidad con todos los nodos, de
+ * modo que sirve de línea base (la NMI de cualquier partición no trivial es 0).
+ * @param n Nº de nodos.
+ * @param p Probabilidad de cada arista.
+ * @param seed Semilla.
+ */
+GeneratedGraph generateErdosRenyi(unsigned int n, double p, unsigned int seed);
+
+/**
+ * @brief Anillo de cliques: n_cliques cliques de clique_size nodos, cada una unida a la siguiente por una arista.
+ * @details Es determinista y la referencia es la clique de cada nodo. Con muchas cliques la modularidad las
+ * fusiona por parejas (límite de resolución), mientras que el CPM con 0 < gamma < 1 las separa.
+ * @param n_cliques Nº de cliques (al menos 2 para formar el anillo).
+ * @param clique_size Nº de nodos de cada clique.
+ */
+GeneratedGraph generateRingOfCliques(unsigned int n_cliques, unsigned int clique_size);
+
+/**
+ * @brief Escribe una lista de aristas en CSV (origen,destino,peso) con cabecera, como la que lee parseEdgeListCSV().
+ * @param filename Nombre del archivo.
+ * @param edges Aristas a escribir.
+ * @return true si se pudo escribir, false en caso contrario.
+ */
+bool writeEdgeListCSV(const std::string& filename, const std::vector<EdgeRecord>& edges);
+
+/**
+ * @brief Información mutua normalizada entre dos particiones de los mismos nodos.
+ * @details NMI = 2 I(A;B) / (H(A) + H(B)), en [0, 1]; vale 1 si las particiones coinciden (salvo el nombre
+ * de las comunidades). Si ambas tienen una sola comunidad se toma 1. Las etiquetas negativas (nodos sin
+ * asignar) se ignoran, junto con el nodo correspondiente de la otra partición.
+ * @param a Comunidad de cada nodo según la primera partición.
+ * @param b Comunidad de cada nodo según la segunda (mismo tamaño que a).
+ */
+double normalizedMutualInformation(const std::vector<int>& a, const std::vector<int>& b);
+
+} // namespace networkStructure
+
+#endif // GRAPHGENERATOR_H
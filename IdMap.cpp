@@ -0,0 +1,69 @@
+#include "IdMap.h"
+#include <unordered_set>
+#include <omp.h>
+
+namespace networkStructure {
+
+void IdMap::build(const std::vector<EdgeRecord>& edges) {
+    index_of.clear();
+    external_ids.clear();
+
+    int P = omp_get_max_threads();
+    if (P < 1) P = 1;
+    std::size_t m = edges.size();
+    if (m < static_cast<std::size_t>(P) * 1024) P = 1; // no compensa dividir listas pequeñas
+
+    // IDs distintos de cada tramo, en orden de primera aparición
+    std::vector<std::vector<std::uint64_t>> local_ids(P);
+    #pragma omp parallel num_threads(P)
+    {
+        int tid = omp_get_thread_num();
+        std::size_t from = m * static_cast<std::size_t>(tid) / static_cast<std::size_t>(P);
+        std::size_t to = m * static_cast<std::size_t>(tid + 1) / static_cast<std::size_t>(P);
+        std::unordered_set<std::uint64_t> seen;
+        seen.reserve((to - from) / 2 + 1);
+        std::vector<std::uint64_t>& order = local_ids[tid];
+        for (std::size_t k = from; k < to; ++k) {
+            if (seen.insert(edges[k].origin).second) order.push_back(edges[k].origin);
+            if (seen.insert(edges[k].destiny).second) order.push_back(edges[k].destiny);
+        }
+    }
+
+    // Fusión en el orden de los tramos
+    std::size_t expected = 0;
+    for (const auto& order : local_ids) expected += order.size();
+    index_of.reserve(expected);
+    external_ids.reserve(expected);
+    for (const auto& order : local_ids) {
+        for (std::uint64_t id : order) {
+            getOrInsert(id);
+        }
+    }
+    external_ids.shrink_to_fit();
+}
+
+void IdMap::translate(std::vector<EdgeRecord>& edges) const {
+    // Solo lecturas concurrentes de index_of
+    #pragma omp parallel for schedule(static)
+    for (std::size_t k = 0; k < edges.size(); ++k) {
+        edges[k].origin = index_of.find(edges[k].origin)->second;
+        edges[k].destiny = index_of.find(edges[k].destiny)->second;
+    }
+}
+
+unsigned int IdMap::getOrInsert(std::uint64_t external_id) {
+    auto result = index_of.emplace(external_id, static_cast<unsigned int>(external_ids.size()));
+    if (result.second) {
+        external_ids.push_back(external_id);
+    }
+    return result.first->second;
+}
+
+bool IdMap::find(std::uint64_t external_id, unsigned int& index) const {
+    auto it = index_of.find(external_id);
+    if (it == index_of.end()) return false;
+    index = it->second;
+    return true;
+}
+
+} // namespace networkStructure
@@ -0,0 +1,76 @@
+#ifndef IDMAP_H
+#define IDMAP_H
+
+#include "EdgeListParser.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace networkStructure {
+
+/**
+ * @class IdMap
+ * @brief Traducción entre IDs externos (dispersos, de 32 o 64 bits) e índices internos densos 0..n-1.
+ * @details Al cargar una red, cada ID externo recibe un índice denso en orden de primera aparición en el
+ * fichero. La red trabaja solo con los índices densos (cada búsqueda de nodo es un acceso a un vector) y
+ * los IDs externos se recuperan únicamente al escribir resultados.
+ */
+class IdMap {
+private:
+    std::unordered_map<std::uint64_t, unsigned int> index_of; ///< ID externo -> índice denso.
+    std::vector<std::uint64_t> external_ids;                  ///< Índice denso -> ID externo.
+
+public:
+    /**
+     * @brief Construye la traducción a partir de una lista de aristas, en paralelo.
+     * @details Cada hilo recorre un tramo contiguo de aristas y registra sus IDs distintos en orden de
+     * aparición; después los tramos se fusionan en orden, de modo que el resultado es el mismo que el de
+     * un recorrido secuencial.
+     * @param edges Aristas con IDs externos.
+     */
+    void build(const std::vector<EdgeRecord>& edges);
+
+    /**
+     * @brief Sustituye en paralelo los IDs externos de las aristas por sus índices densos.
+     * @param edges Aristas con IDs externos ya registrados con build().
+     */
+    void translate(std::vector<EdgeRecord>& edges) const;
+
+    /**
+     * @brief Devuelve el índice denso de un ID externo, registrándolo si es nuevo.
+     */
+    unsigned int getOrInsert(std::uint64_t external_id);
+
+    /**
+     * @brief Busca el índice denso de un ID externo.
+     * @param external_id ID externo.
+     * @param index Índice denso encontrado.
+     * @return true si el ID está registrado, false en caso contrario.
+     */
+    bool find(std::uint64_t external_id, unsigned int& index) const;
+
+    /**
+     * @brief Devuelve el ID externo del índice denso dado.
+     */
+    std::uint64_t getExternal(unsigned int index) const { return external_ids[index]; }
+
+    /**
+     * @brief Indica si el índice denso tiene ID externo (los supernodos creados al fusionar no lo tienen).
+     */
+    bool contains(unsigned int index) const { return index < external_ids.size(); }
+
+    /**
+     * @brief Nº de IDs registrados.
+     */
+    std::size_t size() const { return external_ids.size(); }
+
+    /**
+     * @brief Tabla completa índice denso -> ID externo.
+     */
+    const std::vector<std::uint64_t>& getExternalIDs() const { return external_ids; }
+};
+
+} // namespace networkStructure
+
+#endif // IDMAP_H
@@ -0,0 +1,15 @@
+#include "NeighborAccumulator.h"
+
+namespace networkStructure {
+
+NeighborAccumulator::NeighborAccumulator(std::size_t capacity) {
+    resize(capacity);
+}
+
+void NeighborAccumulator::resize(std::size_t capacity) {
+    weights.assign(capacity, 0.0);
+    flags.assign(capacity, 0);
+    touched.clear();
+}
+
+} // namespace networkStructure
@@ -0,0 +1,87 @@
+#ifndef NEIGHBORACCUMULATOR_H
+#define NEIGHBORACCUMULATOR_H
+
+#include <vector>
+#include <cstddef>
+
+namespace networkStructure {
+
+/**
+ * @class NeighborAccumulator
+ * @brief Acumulador disperso reutilizable de pesos por clave (comunidad o nodo vecino).
+ * @details Combina un vector denso de pesos indexado por clave con la lista de claves tocadas, de modo
+ * que acumular es O(1) y vaciar es O(d), siendo d el nº de claves distintas usadas. Tras reservarse una
+ * vez no realiza ninguna reserva de memoria en el bucle principal. Cada hilo debe usar su propia instancia.
+ */
+class NeighborAccumulator {
+private:
+    std::vector<double> weights; ///< Peso acumulado por clave.
+    std::vector<char> flags;     ///< Marca de las claves que ya están en 'touched'.
+    std::vector<int> touched;    ///< Claves con peso acumulado, en orden de primera aparición.
+
+public:
+    /**
+     * @brief Crea un acumulador para claves en [0, capacity).
+     * @param capacity Mayor clave posible más uno.
+     */
+    explicit NeighborAccumulator(std::size_t capacity = 0);
+
+    /**
+     * @brief Ajusta la capacidad del acumulador y lo vacía.
+     * @param capacity Mayor clave posible más uno.
+     */
+    void resize(std::size_t capacity);
+
+    /**
+     * @brief Suma un peso a una clave.
+     * @param key Clave (ID de comunidad o de nodo).
+     * @param w Peso a sumar.
+     */
+    void add(int key, double w) {
+        if (!flags[key]) {
+            flags[key] = 1;
+            touched.push_back(key);
+        }
+        weights[key] += w;
+    }
+
+    /**
+     * @brief Devuelve el peso acumulado de una clave (0 si no se ha tocado).
+     */
+    double get(int key) const { return weights[key]; }
+
+    /**
+     * @brief Devuelve el vector denso de pesos indexado por clave (ver bestNeighbor()).
+     */
+    const double* getWeights() const { return weights.data(); }
+
+    /**
+     * @brief Indica si la clave tiene algún peso acumulado.
+     */
+    bool contains(int key) const { return flags[key] != 0; }
+
+    /**
+     * @brief Devuelve las claves tocadas desde el último clear().
+     */
+    const std::vector<int>& getKeys() const { return touched; }
+
+    /**
+     * @brief Devuelve la capacidad (mayor clave posible más uno).
+     */
+    std::size_t getCapacity() const { return weights.size(); }
+
+    /**
+     * @brief Vacía el acumulador en O(d) recorriendo solo las claves tocadas.
+     */
+    void clear() {
+        for (int key : touched) {
+            weights[key] = 0.0;
+            flags[key] = 0;
+        }
+        touched.clear();
+    }
+};
+
+} // namespace networkStructure
+
+#endif // NEIGHBORACCUMULATOR_H
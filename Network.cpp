@@ -1,37 +1,81 @@
 #include "Network.h"
 #include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
 #include <vector>
 
 namespace networkStructure {
 
-std::size_t Network::getNNodes(){
-    return nodes.size();
+Network::Network()
+    : node_pool(new ObjectPool<Node>()), edge_pool(new ObjectPool<Edge>()) {
 }
 
-std::size_t Network::getNEdges(){
-    return edges.size();
+Network::~Network() {
+    releaseAll();
+}
+
+void Network::releaseAll() {
+    for (EdgePtr& ptr : edges) ptr.release();
+    for (NodePtr& ptr : nodes) ptr.release();
+    edges.clear();
+    nodes.clear();
+    if (edge_pool) edge_pool->clear();
+    if (node_pool) node_pool->clear();
+    n_nodes = 0;
+    n_edges = 0;
+}
+
+Network& Network::operator=(Network&& other) noexcept {
+    if (this != &other) {
+        // Los objetos actuales se liberan en bloque antes de sustituir los almacenes
+        releaseAll();
+        node_pool = std::move(other.node_pool);
+        edge_pool = std::move(other.edge_pool);
+        nodes = std::move(other.nodes);
+        edges = std::move(other.edges);
+        n_nodes = other.n_nodes;
+        n_edges = other.n_edges;
+        next_edge_id = other.next_edge_id;
+        other.n_nodes = 0;
+        other.n_edges = 0;
+    }
+    return *this;
+}
+
+std::size_t Network::getNNodes() const {
+    return n_nodes;
+}
+
+std::size_t Network::getNEdges() const {
+    return n_edges;
 }
 
 Node* Network::getNode(unsigned int id){
-    auto it = nodes.find(id);
-    return (it == nodes.end()) ? nullptr : it->second.get();
+    return (id < nodes.size()) ? nodes[id].get() : nullptr;
 }
 
 Edge* Network::getEdge(unsigned int id){
-    auto it = edges.find(id);
-    return (it == edges.end()) ? nullptr : it->second.get();
+    return (id < edges.size()) ? edges[id].get() : nullptr;
 }
 
 Node* Network::addNode(unsigned int id) {
-    auto it = nodes.find(id);
     // Si el nodo ya existe, devolvemos el puntero existente.
-    if (it != nodes.end()) {
-        return it->second.get();
+    if (id < nodes.size() && nodes[id]) {
+        return nodes[id].get();
+    }
+    // Los IDs son índices densos: solo se admite uno dentro del rango reservado o el siguiente al último
+    if (id > nodes.size()) {
+        throw std::out_of_range("Network::addNode: ID " + std::to_string(id) + " fuera del rango de IDs densos (" +
+                                std::to_string(nodes.size()) + "); reserve() o IdMap");
+    }
+    if (id == nodes.size()) {
+        nodes.emplace_back();
     }
-    // Si no, creamos uno nuevo, lo movemos al mapa y devolvemos el puntero.
-    auto ptr = std::make_unique<Node>(id);
-    Node* raw_ptr = ptr.get();
-    nodes.emplace(id, std::move(ptr));
+    // Si no, lo creamos en el almacén de nodos, lo registramos en su posición y devolvemos el puntero.
+    Node* raw_ptr = node_pool->create(id);
+    nodes[id] = NodePtr(raw_ptr, PoolDeleter<Node>{node_pool.get()});
+    ++n_nodes;
     return raw_ptr;
 }
 
@@ -42,11 +86,11 @@ Edge* Network::addEdge(unsigned int id_origin, unsigned int id_destiny, double w
 
     // Creamos la nueva arista con un ID único.
     unsigned int eid = next_edge_id++;
-    auto eptr = std::make_unique<Edge>(eid, n1, n2, weight);
-    Edge* raw_ptr = eptr.get();
+    Edge* raw_ptr = edge_pool->create(eid, n1, n2, weight);
 
     // Registramos la arista en la red.
-    edges.emplace(eid, std::move(eptr));
+    edges.emplace_back(raw_ptr, PoolDeleter<Edge>{edge_pool.get()});
+    ++n_edges;
 
     // Añadimos la arista a la lista de adyacencia de los nodos.
     n1->addEdge(raw_ptr);
@@ -57,37 +101,131 @@ Edge* Network::addEdge(unsigned int id_origin, unsigned int id_destiny, double w
     return raw_ptr;
 }
 
+void Network::reserve(std::size_t node_bound, std::size_t edge_count) {
+    if (node_bound > nodes.size()) {
+        nodes.resize(node_bound);
+    }
+    edges.reserve(static_cast<std::size_t>(next_edge_id) + edge_count);
+}
+
+unsigned int Network::addEdges(const std::vector<EdgeRecord>& records) {
+    unsigned int first_id = next_edge_id;
+    std::uint64_t max_id = 0;
+    for (const EdgeRecord& r : records) {
+        max_id = std::max(max_id, std::max(r.origin, r.destiny));
+    }
+    if (!records.empty()) {
+        reserve(static_cast<std::size_t>(max_id) + 1, records.size());
+    }
+    for (const EdgeRecord& r : records) {
+        addEdge(static_cast<unsigned int>(r.origin), static_cast<unsigned int>(r.destiny), r.weight);
+    }
+    return first_id;
+}
+
 void Network::removeEdge(unsigned int id){
-    auto it = edges.find(id);
-    if (it == edges.end()) return; // La arista no existe.
+    Edge* e = getEdge(id);
+    if (!e) return; // La arista no existe.
 
-    Edge* e = it->second.get();
     Node* o = e->getOrigin();
     Node* d = e->getDestiny();
 
-    // Eliminar la arista de las listas de adyacencia de los nodos conectados.
+    // Eliminar la arista de las listas de adyacencia de los nodos conectados (O(1) cada una).
     if (o) o->eraseEdge(e);
     if (d && d != o) d->eraseEdge(e);
 
-    // Eliminar la arista del mapa de la red.
-    edges.erase(it);
+    // Eliminar la arista de la red (su posición queda vacía).
+    edges[id].reset();
+    --n_edges;
+}
+
+std::size_t Network::removeEdges(const std::vector<unsigned int>& ids) {
+    // Marcamos las aristas y anotamos cada extremo afectado
+    std::vector<unsigned int> removed;
+    std::vector<std::pair<Node*, Edge*>> affected;
+    removed.reserve(ids.size());
+    affected.reserve(2 * ids.size());
+    for (unsigned int id : ids) {
+        Edge* e = getEdge(id);
+        if (!e || e->isRemoved()) continue;
+        e->markRemoved();
+        removed.push_back(id);
+        affected.emplace_back(e->getOrigin(), e);
+        if (e->getDestiny() != e->getOrigin()) affected.emplace_back(e->getDestiny(), e);
+    }
+    updateAdjacency(affected);
+    for (unsigned int id : removed) {
+        edges[id].reset();
+    }
+    n_edges -= removed.size();
+    return removed.size();
+}
+
+void Network::updateAdjacency(std::vector<std::pair<Node*, Edge*>>& affected) {
+    std::sort(affected.begin(), affected.end());
+    for (std::size_t first = 0; first < affected.size();) {
+        Node* n = affected[first].first;
+        std::size_t last = first;
+        while (last < affected.size() && affected[last].first == n) ++last;
+        // Con pocas aristas marcadas frente al grado, quitarlas una a una (O(1) cada una) es más barato
+        // que recorrer toda la lista
+        if ((last - first) * COMPACT_RATIO < n->getAdjList().size()) {
+            for (std::size_t k = first; k < last; ++k) n->eraseEdge(affected[k].second);
+        } else {
+            n->compactEdges();
+        }
+        first = last;
+    }
 }
 
 void Network::removeNode(unsigned int id){
-    auto it = nodes.find(id);
-    if (it == nodes.end()) return; // El nodo no existe.
+    Node* n = getNode(id);
+    if (!n) return; // El nodo no existe.
+
+    // Cada removeEdge() quita la arista de la lista del nodo, así que basta con quitar la última hasta vaciarla.
+    while (!n->getAdjList().empty()) {
+        removeEdge(n->getAdjList().back()->getID());
+    }
+
+    // Finalmente, eliminar el nodo de la red (su posición queda vacía).
+    nodes[id].reset();
+    --n_nodes;
+}
 
-    Node* n = it->second.get();
-    
-    // Es necesario copiar la lista de aristas antes de iterar, porque `removeEdge` modificará la lista de adyacencia del nodo.
-    std::vector<Edge*> incident_edges = n->getAdjList();
-    for (Edge* e : incident_edges) {
-        //Eliminar la arista de la red.
-        if (e) removeEdge(e->getID());
+std::size_t Network::removeNodes(const std::vector<unsigned int>& ids) {
+    std::vector<unsigned int> doomed;
+    doomed.reserve(ids.size());
+    for (unsigned int id : ids) {
+        if (getNode(id)) doomed.push_back(id);
     }
+    std::sort(doomed.begin(), doomed.end());
+    doomed.erase(std::unique(doomed.begin(), doomed.end()), doomed.end());
 
-    // Finalmente, eliminar el nodo del mapa de la red.
-    nodes.erase(it);
+    // Marcamos las aristas incidentes; solo hay que actualizar las listas de los vecinos que se quedan
+    std::vector<Edge*> removed;
+    std::vector<std::pair<Node*, Edge*>> affected;
+    for (unsigned int id : doomed) {
+        Node* n = nodes[id].get();
+        for (Edge* e : n->getAdjList()) {
+            if (e->isRemoved()) continue; // Arista entre dos nodos del lote, ya marcada.
+            e->markRemoved();
+            removed.push_back(e);
+            Node* other = e->getOpposite(n);
+            if (other && other != n && !std::binary_search(doomed.begin(), doomed.end(), other->getID())) {
+                affected.emplace_back(other, e);
+            }
+        }
+    }
+    updateAdjacency(affected);
+    for (Edge* e : removed) {
+        edges[e->getID()].reset();
+    }
+    n_edges -= removed.size();
+    for (unsigned int id : doomed) {
+        nodes[id].reset();
+    }
+    n_nodes -= doomed.size();
+    return doomed.size();
 }
 
 std::vector<Edge*> Network::getEdgesOfNode(unsigned int id){
@@ -96,4 +234,28 @@ std::vector<Edge*> Network::getEdgesOfNode(unsigned int id){
     return n->getAdjList();
 }
 
+MemoryUsage Network::getMemoryUsage() const {
+    MemoryUsage usage;
+    if (node_pool) usage.node_bytes = node_pool->getReservedBytes();
+    if (edge_pool) usage.edge_bytes = edge_pool->getReservedBytes();
+    for (const NodePtr& ptr : nodes) {
+        Node* node = ptr.get();
+        if (!node) continue;
+        usage.adjacency_bytes += node->getAdjList().capacity() * sizeof(Edge*);
+    }
+
+    std::size_t node_index = nodes.capacity() * sizeof(NodePtr);
+    std::size_t edge_index = edges.capacity() * sizeof(EdgePtr);
+    usage.index_bytes = node_index + edge_index;
+    usage.total_bytes = usage.node_bytes + usage.edge_bytes + usage.adjacency_bytes + usage.index_bytes;
+
+    if (n_nodes > 0) {
+        usage.bytes_per_node = static_cast<double>(usage.node_bytes + usage.adjacency_bytes + node_index) / n_nodes;
+    }
+    if (n_edges > 0) {
+        usage.bytes_per_edge = static_cast<double>(usage.edge_bytes + edge_index) / n_edges;
+    }
+    return usage;
+}
+
 } // namespace networkStructure
\ No newline at end of file
@@ -2,43 +2,96 @@
 #define NETWORK_H
 
 #include <vector>
-#include <map>
 #include <memory>
+#include <utility>
 #include "Node.h"
 #include "Edge.h"
+#include "ObjectPool.h"
+#include "EdgeListParser.h"
 
 namespace networkStructure {
 
+/**
+ * @struct MemoryUsage
+ * @brief Informe del uso de memoria de una red.
+ */
+struct MemoryUsage {
+    std::size_t node_bytes = 0;      ///< Bloques reservados para los objetos Node.
+    std::size_t edge_bytes = 0;      ///< Bloques reservados para los objetos Edge.
+    std::size_t adjacency_bytes = 0; ///< Listas de adyacencia de los nodos.
+    std::size_t index_bytes = 0;     ///< Vectores ID -> objeto.
+    std::size_t total_bytes = 0;     ///< Suma de todo lo anterior.
+    double bytes_per_node = 0.0;     ///< (node_bytes + adjacency_bytes + índice de nodos) / nº de nodos.
+    double bytes_per_edge = 0.0;     ///< (edge_bytes + índice de aristas) / nº de aristas.
+};
+
+/**
+ * @class Network
+ * @brief Red no dirigida y ponderada de nodos y aristas.
+ * @details Los nodos y aristas se guardan en vectores indexados directamente por su ID, por lo que cada
+ * búsqueda es un acceso a un vector. Los IDs de nodo deben ser índices densos (0..n-1); los IDs externos
+ * de los ficheros, que pueden ser dispersos o de 64 bits, se traducen con IdMap al cargar la red. Al
+ * eliminar un nodo o una arista su posición queda vacía (nullptr).
+ */
 class Network {
+public:
+    // Los objetos viven en almacenes por bloques; el unique_ptr solo los devuelve a su almacén.
+    using NodePtr = std::unique_ptr<Node, PoolDeleter<Node>>;
+    using EdgePtr = std::unique_ptr<Edge, PoolDeleter<Edge>>;
+
 private:
-    // Usamos unique_ptr para la gestión automática de memoria de nodos y aristas.
-    std::map<unsigned int, std::unique_ptr<Node>> nodes;
-    std::map<unsigned int, std::unique_ptr<Edge>> edges;
+    // Los almacenes se declaran antes que los vectores para destruirse después de ellos. Se guardan
+    // por puntero para que su dirección (usada por los deleters) no cambie al mover la red.
+    std::unique_ptr<ObjectPool<Node>> node_pool;
+    std::unique_ptr<ObjectPool<Edge>> edge_pool;
+    std::vector<NodePtr> nodes; // nodes[id] = nodo con ese ID, o nullptr.
+    std::vector<EdgePtr> edges; // edges[id] = arista con ese ID, o nullptr.
+    std::size_t n_nodes = 0;    // Nº de nodos existentes.
+    std::size_t n_edges = 0;    // Nº de aristas existentes.
     unsigned int next_edge_id = 0; // Contador para los IDs de arista únicos.
 
+    // Una lista de adyacencia se compacta entera si tiene al menos 1/COMPACT_RATIO de aristas marcadas.
+    static constexpr std::size_t COMPACT_RATIO = 8;
+
+    /**
+     * @brief Quita de las listas de adyacencia las aristas marcadas como eliminadas en un lote.
+     * @details Por cada nodo afectado, compacta su lista una vez (conservando el orden) si el lote le quita
+     * una parte apreciable de sus aristas, o quita cada arista en O(1) en caso contrario.
+     * @param affected Pares (nodo que se queda, arista marcada de su lista); se ordena.
+     */
+    void updateAdjacency(std::vector<std::pair<Node*, Edge*>>& affected);
+
+    /**
+     * @brief Vacía la red liberando los almacenes de nodos y aristas en bloque (ObjectPool::clear()).
+     * @details Los punteros se sueltan sin pasar por sus deleters, por lo que ningún objeto se devuelve uno
+     * a uno a su almacén.
+     */
+    void releaseAll();
+
 public:
     /**
      * @brief Constructor y destructor de la clase Network.
+     * @details Los nodos y aristas se reservan en bloques (ObjectPool) y se liberan en bloque al destruir la red.
      */
-    Network() = default;
-    ~Network() = default;
+    Network();
+    ~Network();
 
     Network(const Network&) = delete;
     Network& operator=(const Network&) = delete;
     Network(Network&&) = default;
-    Network& operator=(Network&&) = default;
+    Network& operator=(Network&& other) noexcept;
 
     /**
      * @brief Devuelve el número total de nodos en la red.
-     * @return El tamaño del mapa de nodos.
+     * @return El número de nodos existentes.
      */
-    std::size_t getNNodes();
+    std::size_t getNNodes() const;
 
     /**
      * @brief Devuelve el número total de aristas en la red.
-     * @return El tamaño del mapa de aristas.
+     * @return El número de aristas existentes.
      */
-    std::size_t getNEdges();
+    std::size_t getNEdges() const;
 
     /**
      * @brief Busca y devuelve un puntero a un nodo por su ID.
@@ -56,14 +109,18 @@ public:
 
     /**
      * @brief Añade un nuevo nodo a la red si no existe.
+     * @details El ID debe estar en el rango reservado con reserve() o ser igual a getIdBound() (el rango
+     * crece en uno), de modo que los IDs sigan siendo densos. Los IDs externos se traducen antes con IdMap.
      * @param id El ID del nodo a añadir.
      * @return Puntero al nodo nuevo o al ya existente.
+     * @throws std::out_of_range si id es mayor que getIdBound().
      */
     Node* addNode(unsigned int id);
 
     /**
      * @brief Añade una arista entre dos nodos.
-     * @details Si los nodos no existen, se crean. Permite aristas paralelas.
+     * @details Si los nodos no existen, se crean con addNode() (mismas condiciones sobre sus IDs). Permite
+     * aristas paralelas.
      * @param id_origin ID del nodo de origen.
      * @param id_destiny ID del nodo de destino.
      * @param weight Peso de la arista.
@@ -71,20 +128,61 @@ public:
      */
     Edge* addEdge(unsigned int id_origin, unsigned int id_destiny, double weight);
 
+    /**
+     * @brief Reserva espacio para construir la red de una vez sin realojar sus vectores.
+     * @details Fija el rango de IDs de nodo en al menos [0, node_bound): a partir de aquí addNode() admite
+     * cualquier ID de ese rango. El vector de nodos se redimensiona, por lo que se ocupa ya una posición
+     * (un puntero vacío) por cada ID del rango aunque sus nodos no se añadan después.
+     * @param node_bound Mayor ID de nodo que se va a añadir más uno.
+     * @param edge_count Nº de aristas que se van a añadir.
+     */
+    void reserve(std::size_t node_bound, std::size_t edge_count);
+
+    /**
+     * @brief Añade un lote de aristas de una vez.
+     * @details Equivale a llamar a addEdge() con cada registro, pero reserva una sola vez los vectores de la
+     * red. Los IDs de los registros deben ser ya los de la red (índices densos, ver IdMap::translate()).
+     * @param records Aristas a añadir (origen, destino y peso).
+     * @return ID de la primera arista añadida; las demás tienen IDs consecutivos en el orden de 'records'.
+     */
+    unsigned int addEdges(const std::vector<EdgeRecord>& records);
+
     /**
      * @brief Elimina una arista de la red por su ID.
-     * @details También la elimina de la lista de adyacencia de los nodos conectados.
+     * @details También la elimina de la lista de adyacencia de los nodos conectados, en O(1): cada arista
+     * guarda su posición en ambas listas y la última arista de cada lista ocupa su hueco.
      * @param id El ID de la arista a eliminar.
      */
     void removeEdge(unsigned int id);
 
+    /**
+     * @brief Elimina un lote de aristas por su ID.
+     * @details Marca las aristas como eliminadas y actualiza una sola vez la lista de adyacencia de cada nodo
+     * afectado: la compacta si pierde una parte apreciable de sus aristas o quita cada una en O(1) si son
+     * pocas. Los IDs inexistentes o repetidos se ignoran.
+     * Complejidad: O(k log k + suma de los grados de los nodos afectados), siendo k el tamaño del lote.
+     * @param ids IDs de las aristas a eliminar.
+     * @return Nº de aristas eliminadas.
+     */
+    std::size_t removeEdges(const std::vector<unsigned int>& ids);
+
     /**
      * @brief Elimina un nodo de la red por su ID.
-     * @details Elimina también todas las aristas incidentes al nodo.
+     * @details Elimina también todas las aristas incidentes al nodo. O(grado del nodo).
      * @param id El ID del nodo a eliminar.
      */
     void removeNode(unsigned int id);
 
+    /**
+     * @brief Elimina un lote de nodos por su ID junto con sus aristas incidentes.
+     * @details Marca las aristas incidentes como eliminadas y actualiza una sola vez la lista de adyacencia de
+     * cada vecino que sigue en la red, como removeEdges(). Los IDs inexistentes o repetidos se ignoran.
+     * Complejidad: O(k log k + suma de los grados de los nodos eliminados y de sus vecinos).
+     * @param ids IDs de los nodos a eliminar.
+     * @return Nº de nodos eliminados.
+     */
+    std::size_t removeNodes(const std::vector<unsigned int>& ids);
+
     /**
      * @brief Obtiene una lista de todas las aristas incidentes a un nodo.
      * @param id El ID del nodo.
@@ -93,20 +191,36 @@ public:
     std::vector<Edge*> getEdgesOfNode(unsigned int id);
 
     /**
-    * @brief Devuelve una referencia constante al mapa de nodos.
-    * @details Se utiliza para permitir la iteración sobre todos los nodos de la red.
-    * @return Una referencia constante al mapa que almacena los nodos.
+     * @brief Calcula la memoria usada por la red.
+     * @return Informe con los bytes por categoría y los bytes por nodo y por arista.
+     */
+    MemoryUsage getMemoryUsage() const;
+
+    /**
+     * @brief Devuelve el mayor ID de nodo posible más uno (tamaño del vector de nodos).
+     * @details Sirve para dimensionar estructuras densas indexadas por ID de nodo o de comunidad.
+     */
+    std::size_t getIdBound() const {
+        return nodes.size();
+    }
+
+    /**
+    * @brief Devuelve una referencia constante al vector de nodos, indexado por ID.
+    * @details Se utiliza para permitir la iteración sobre todos los nodos de la red en orden de ID.
+    * Las posiciones de los nodos eliminados contienen nullptr.
+    * @return Una referencia constante al vector que almacena los nodos.
     */
-    const std::map<unsigned int, std::unique_ptr<Node>>& getNodesMap() const {
-    return nodes;
+    const std::vector<NodePtr>& getNodes() const {
+        return nodes;
     }
 
     /**
-    * @brief Devuelve una referencia constante al mapa de aristas.
-    * @details Permite la iteración segura sobre todas las aristas de la red.
-    * @return Una referencia constante al mapa que almacena las aristas.
+    * @brief Devuelve una referencia constante al vector de aristas, indexado por ID.
+    * @details Permite la iteración segura sobre todas las aristas de la red. Las posiciones de las
+    * aristas eliminadas contienen nullptr.
+    * @return Una referencia constante al vector que almacena las aristas.
     */
-    const std::map<unsigned int, std::unique_ptr<Edge>>& getEdgesMap() const {
+    const std::vector<EdgePtr>& getEdges() const {
         return edges;
     }
 };
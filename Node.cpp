@@ -6,58 +6,65 @@
 namespace networkStructure {
 
 Node::Node(unsigned int id0)
-    : id(id0), community(1), adjList(), members() {}
+    : id(id0), adjList(), size(1) {}
 
-unsigned int Node::getID() {
+unsigned int Node::getID() const {
     return id;
 }
 
-int Node::getCommunity() {
-    return community;
-}
-
-void Node::setCommunity(int c) {
-    community = c;
-}
-
-std::size_t Node::getDegree(){
+std::size_t Node::getDegree() const {
     return adjList.size(); 
 }
 
-const std::vector<Edge*>& Node::getAdjList() {
+const std::vector<Edge*>& Node::getAdjList() const {
     return adjList;
 }
 
-bool Node::equals(Node *node) {
+bool Node::equals(const Node *node) const {
     if (node == nullptr) return false;
     return (id == node->getID());
 }
 
 void Node::addEdge(Edge *edge) {
     if (edge->getDestiny()->equals(this) || edge->getOrigin()->equals(this)) {
+        edge->setPosition(this, static_cast<unsigned int>(adjList.size()));
         adjList.push_back(edge);
     }
 }
 
 void Node::eraseEdge(Edge *edge) {
-    auto it = std::remove(adjList.begin(), adjList.end(), edge);
-    adjList.erase(it, adjList.end());
+    unsigned int pos = edge->getPosition(this);
+    if (pos >= adjList.size() || adjList[pos] != edge) return; // La arista no está en la lista.
+    Edge* last = adjList.back();
+    adjList[pos] = last;
+    last->setPosition(this, pos);
+    adjList.pop_back();
 }
 
-void Node::eraseAllEdges() {
-    adjList.clear();
+void Node::compactEdges() {
+    std::size_t kept = 0;
+    for (Edge* edge : adjList) {
+        if (edge->isRemoved()) continue;
+        edge->setPosition(this, static_cast<unsigned int>(kept));
+        adjList[kept++] = edge;
+    }
+    adjList.resize(kept);
+}
+
+void Node::reserveEdges(std::size_t degree) {
+    adjList.reserve(degree);
 }
 
-void Node::addMember(unsigned int member_id) {
-    members.push_back(member_id);
+void Node::eraseAllEdges() {
+    adjList.clear();
 }
 
-const std::vector<unsigned int>& Node::getMembers() const {
-    return members;
+unsigned int Node::getSize() const {
+    return size;
 }
 
-void Node::setMembers(const std::vector<unsigned int>& new_members) {
-    members = new_members;
+void Node::setSize(unsigned int new_size) {
+    size = new_size;
 }
 
 Node::~Node() {
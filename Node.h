@@ -10,19 +10,18 @@ class Edge;
 /**
  * @class Node
  * @brief Representa un nodo en la red.
- * @details El nodo almacena su identificador, la comunidad a la que pertenece y las aristas que conectan con él. 
+ * @details El nodo almacena su identificador y las aristas que conectan con él. La comunidad de cada nodo
+ * no forma parte de la red: se guarda aparte, en un objeto Partition.
  */
 class Node {
 private:
     unsigned int id; ///< Identificador único del nodo.
-    int community; ///< ID de la comunidad a la que pertenece el nodo.
     std::vector<Edge*> adjList; ///< Lista de punteros a las aristas incidentes.
-    std::vector<unsigned int> members; ///< IDs de nodos si este nodo representa una comunidad fusionada.
+    unsigned int size; ///< Nº de nodos originales si este nodo representa una comunidad fusionada.
 
 public:
     /**
      * @brief Crea un nodo con un ID.
-     * @details La comunidad por defecto es 1.
      * @param id Identificador único para el nodo.
      */
     Node(unsigned int id);
@@ -31,38 +30,26 @@ public:
      * @brief Devuelve el ID del nodo.
      * @return El identificador del nodo.
      */
-    unsigned int getID();
-
-    /**
-     * @brief Devuelve la comunidad a la que está asignado el nodo.
-     * @return El ID de la comunidad.
-     */
-    int getCommunity();
-
-    /**
-     * @brief Asigna el nodo a una comunidad.
-     * @param c El nuevo ID de comunidad.
-     */
-    void setCommunity(int c);
+    unsigned int getID() const;
 
     /**
      * @brief Devuelve el grado del nodo.
      * @return El número de aristas incidentes al nodo.
      */
-    std::size_t getDegree(); 
+    std::size_t getDegree() const;
 
     /**
      * @brief Proporciona acceso de solo lectura a la lista de aristas.
      * @return Referencia constante al vector de punteros de aristas.
      */
-    const std::vector<Edge*>& getAdjList();
+    const std::vector<Edge*>& getAdjList() const;
 
     /**
      * @brief Comprueba si el nodo actual y el nodo dado son iguales según su id.
      * @param node Puntero a otro objeto Node.
      * @return true si los nodos son iguales, false en caso contrario.
      */
-    bool equals(Node *node);
+    bool equals(const Node *node) const;
 
     /**
      * @brief Añade una arista a la lista de aristas del nodo actual.
@@ -72,31 +59,41 @@ public:
 
     /**
      * @brief Borra una arista de la lista de aristas del nodo actual.
+     * @details La última arista de la lista ocupa su hueco (la posición guardada en la arista evita buscarla),
+     * por lo que es O(1) pero no conserva el orden de la lista.
      * @param edge Puntero a un objeto Edge.
      */
     virtual void eraseEdge(Edge *edge);
 
     /**
-     * @brief Borra todas las aristas de la lista de aristas del nodo actual.
+     * @brief Quita de una vez todas las aristas marcadas como eliminadas (Edge::markRemoved()).
+     * @details Conserva el orden del resto y actualiza sus posiciones. O(grado).
      */
-    void eraseAllEdges();
+    void compactEdges();
+
+    /**
+     * @brief Reserva espacio en la lista de aristas para un grado conocido de antemano.
+     * @param degree Nº de aristas que tendrá el nodo.
+     */
+    void reserveEdges(std::size_t degree);
 
     /**
-     * @brief Añade un ID de nodo a la lista de nodos cuando se fusiona una comunidad.
-     * @param member_id ID del nodo a añadir.
+     * @brief Borra todas las aristas de la lista de aristas del nodo actual.
      */
-    void addMember(unsigned int member_id);
+    void eraseAllEdges();
 
     /**
-     * @brief Devuelve los IDs de nodos originales contenidos en este nodo.
+     * @brief Devuelve el nº de nodos originales contenidos en este nodo (1 si no es un supernodo).
+     * @details Es el tamaño del nodo en el CPM. Qué nodos originales contiene un supernodo lo guarda el
+     * Dendrogram de las agregaciones, no el nodo.
      */
-    const std::vector<unsigned int>& getMembers() const;
+    unsigned int getSize() const;
 
     /**
-     * @brief Permite establecer la lista de miembros del nodo.
-     * @param new_members Vector con los IDs de los nodos.
+     * @brief Establece el nº de nodos originales contenidos en este nodo.
+     * @param new_size Nº de nodos originales.
      */
-    void setMembers(const std::vector<unsigned int>& new_members);
+    void setSize(unsigned int new_size);
 
     /**
      * @brief Destructor de la clase Node.
@@ -0,0 +1,134 @@
+#ifndef OBJECTPOOL_H
+#define OBJECTPOOL_H
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <type_traits>
+
+namespace networkStructure {
+
+/**
+ * @class ObjectPool
+ * @brief Almacén de objetos por bloques (slab/arena) con direcciones estables.
+ * @details Los objetos se construyen en bloques contiguos de SLAB_SIZE posiciones en lugar de reservarse uno
+ * a uno en el heap. Las posiciones de los objetos destruidos se reutilizan mediante una lista libre, y toda
+ * la memoria se libera en bloque con clear() o al destruir el almacén, que destruyen también los objetos
+ * vivos. Los objetos nunca se mueven, por lo que los punteros devueltos por create() son válidos hasta su
+ * destroy() o clear().
+ * @tparam T Tipo de objeto almacenado.
+ */
+template <typename T>
+class ObjectPool {
+public:
+    static const std::size_t SLAB_SIZE = 4096; ///< Nº de objetos por bloque.
+
+private:
+    struct alignas(T) Slot {
+        unsigned char bytes[sizeof(T)];
+    };
+
+    std::vector<std::unique_ptr<Slot[]>> slabs; ///< Bloques reservados.
+    std::size_t used_in_last = SLAB_SIZE;       ///< Posiciones usadas del último bloque.
+    std::vector<T*> free_list;                  ///< Posiciones liberadas disponibles para reutilizar.
+    std::size_t live = 0;                       ///< Nº de objetos vivos.
+
+public:
+    ObjectPool() = default;
+    ~ObjectPool() { clear(); }
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    /**
+     * @brief Construye un objeto en el almacén.
+     * @param args Argumentos del constructor de T.
+     * @return Puntero estable al objeto creado.
+     */
+    template <typename... Args>
+    T* create(Args&&... args) {
+        void* place;
+        if (!free_list.empty()) {
+            place = free_list.back();
+            free_list.pop_back();
+        } else {
+            if (used_in_last == SLAB_SIZE) {
+                slabs.emplace_back(new Slot[SLAB_SIZE]);
+                used_in_last = 0;
+            }
+            place = &slabs.back()[used_in_last++];
+        }
+        T* obj = new (place) T(std::forward<Args>(args)...);
+        ++live;
+        return obj;
+    }
+
+    /**
+     * @brief Destruye un objeto y deja su posición disponible para reutilizarla.
+     * @param obj Objeto creado con create().
+     */
+    void destroy(T* obj) {
+        if (!obj) return;
+        if (!std::is_trivially_destructible<T>::value) {
+            obj->~T();
+        }
+        free_list.push_back(obj);
+        --live;
+    }
+
+    /**
+     * @brief Destruye todos los objetos vivos y libera los bloques de una vez.
+     * @details Si T tiene destructor trivial solo se liberan los bloques; si no, se recorren las posiciones
+     * usadas de cada bloque saltando las de la lista libre (ya destruidas). Ningún objeto pasa por la lista
+     * libre, y los punteros de los objetos del almacén dejan de ser válidos.
+     */
+    void clear() {
+        if (!std::is_trivially_destructible<T>::value && live > 0) {
+            std::sort(free_list.begin(), free_list.end(), std::less<T*>());
+            for (std::size_t s = 0; s < slabs.size(); ++s) {
+                std::size_t used = (s + 1 == slabs.size()) ? used_in_last : SLAB_SIZE;
+                for (std::size_t i = 0; i < used; ++i) {
+                    T* obj = reinterpret_cast<T*>(&slabs[s][i]);
+                    if (!std::binary_search(free_list.begin(), free_list.end(), obj, std::less<T*>())) {
+                        obj->~T();
+                    }
+                }
+            }
+        }
+        slabs.clear();
+        free_list.clear();
+        used_in_last = SLAB_SIZE;
+        live = 0;
+    }
+
+    /**
+     * @brief Nº de objetos vivos.
+     */
+    std::size_t getLiveCount() const { return live; }
+
+    /**
+     * @brief Bytes reservados en bloques y en la lista libre.
+     */
+    std::size_t getReservedBytes() const {
+        return slabs.size() * SLAB_SIZE * sizeof(Slot) + free_list.capacity() * sizeof(T*);
+    }
+};
+
+/**
+ * @struct PoolDeleter
+ * @brief Deleter para std::unique_ptr que devuelve el objeto a su ObjectPool.
+ */
+template <typename T>
+struct PoolDeleter {
+    ObjectPool<T>* pool = nullptr;
+    void operator()(T* obj) const {
+        if (pool) pool->destroy(obj);
+    }
+};
+
+} // namespace networkStructure
+
+#endif // OBJECTPOOL_H
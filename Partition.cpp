@@ -0,0 +1,54 @@
+#include "Partition.h"
+
+namespace networkStructure {
+
+Partition::Partition() : state(0) {
+}
+
+Partition::Partition(Network& net) : state(0) {
+    reset(net);
+}
+
+void Partition::reset(Network& net) {
+    labels.assign(net.getIdBound(), -1);
+    for (const auto& ptr : net.getNodes()) {
+        if (ptr) labels[ptr->getID()] = static_cast<int>(ptr->getID());
+    }
+    rebuild(net);
+}
+
+void Partition::rebuild(Network& net) {
+    state.reset(net.getIdBound());
+    for (const auto& ptr : net.getNodes()) {
+        Node* node = ptr.get();
+        if (!node) continue;
+        int comm = labels[node->getID()];
+        double degree = 0.0;
+        double self_loop = 0.0;
+        double k_in = 0.0;
+        for (Edge* e : node->getAdjList()) {
+            if (!e) continue;
+            Node* neighbor = e->getOpposite(node);
+            if (neighbor == node) {
+                self_loop += e->getWeight();
+                degree += 2.0 * e->getWeight();
+                continue;
+            }
+            degree += e->getWeight();
+            // Cada arista interna se visita desde sus dos extremos: la mitad en cada uno
+            if (neighbor && labels[neighbor->getID()] == comm) k_in += 0.5 * e->getWeight();
+        }
+        unsigned int node_size = node->getSize();
+        state.addNode(comm, node_size, degree, k_in, self_loop);
+    }
+}
+
+void Partition::moveNode(unsigned int id, int to, unsigned int node_size, double degree, double k_in_from,
+                         double k_in_to, double self_loop) {
+    int from = labels[id];
+    if (from == to) return;
+    state.moveNode(from, to, node_size, degree, k_in_from, k_in_to, self_loop);
+    labels[id] = to;
+}
+
+} // namespace networkStructure
@@ -0,0 +1,95 @@
+#ifndef PARTITION_H
+#define PARTITION_H
+
+#include "Network.h"
+#include "CommunityState.h"
+
+#include <vector>
+#include <cstddef>
+
+namespace networkStructure {
+
+/**
+ * @class Partition
+ * @brief Asignación de los nodos de una red a comunidades, separada de la propia red.
+ * @details Guarda la etiqueta de comunidad de cada nodo en un vector denso indexado por su ID y los
+ * agregados de cada comunidad (CommunityState). La Network queda como topología de solo lectura, de modo
+ * que varias particiones (y varios Algoritmo) pueden trabajar a la vez sobre la misma red en memoria.
+ * Los IDs de comunidad están en [0, getIdBound() de la red), normalmente el ID de uno de sus nodos.
+ */
+class Partition {
+private:
+    std::vector<int> labels; ///< Comunidad de cada ID de nodo (-1 si el ID no tiene nodo).
+    CommunityState state;    ///< Tamaño, peso interno y grado total de cada comunidad.
+
+public:
+    /**
+     * @brief Crea una partición vacía, que debe inicializarse con reset() antes de usarse.
+     */
+    Partition();
+
+    /**
+     * @brief Crea la partición en la que cada nodo de la red es su propia comunidad.
+     */
+    explicit Partition(Network& net);
+
+    /**
+     * @brief Vuelve a la partición en la que cada nodo es su propia comunidad (comunidad i = nodo i).
+     * @param net Red sobre la que se define la partición (solo se lee).
+     */
+    void reset(Network& net);
+
+    /**
+     * @brief Recalcula los agregados de cada comunidad a partir de las etiquetas actuales en O(n + m).
+     * @details Necesario tras cambiar etiquetas con setCommunity().
+     * @param net Red sobre la que se define la partición (solo se lee).
+     */
+    void rebuild(Network& net);
+
+    /**
+     * @brief Indica si la partición está dimensionada para la red dada.
+     */
+    bool matches(const Network& net) const { return labels.size() == net.getIdBound(); }
+
+    /**
+     * @brief Devuelve la comunidad del nodo con el ID dado.
+     */
+    int getCommunity(unsigned int id) const { return labels[id]; }
+
+    /**
+     * @brief Cambia la etiqueta de un nodo sin actualizar los agregados (ver rebuild()).
+     */
+    void setCommunity(unsigned int id, int c) { labels[id] = c; }
+
+    /**
+     * @brief Mueve un nodo a otra comunidad actualizando su etiqueta y los agregados en O(1).
+     * @param id ID del nodo.
+     * @param to Comunidad destino.
+     * @param node_size Nº de nodos originales que representa el nodo.
+     * @param degree Grado ponderado del nodo.
+     * @param k_in_from Peso de las aristas del nodo hacia el resto de su comunidad actual.
+     * @param k_in_to Peso de las aristas del nodo hacia la comunidad destino.
+     * @param self_loop Peso de los bucles del nodo.
+     */
+    void moveNode(unsigned int id, int to, unsigned int node_size, double degree, double k_in_from, double k_in_to,
+                  double self_loop);
+
+    /**
+     * @brief Agregados por comunidad (tamaños, pesos internos y grados totales).
+     */
+    const CommunityState& getState() const { return state; }
+
+    /**
+     * @brief Nº de comunidades no vacías.
+     */
+    std::size_t getNCommunities() const { return state.getNCommunities(); }
+
+    /**
+     * @brief Etiquetas de todos los IDs de nodo.
+     */
+    const std::vector<int>& getLabels() const { return labels; }
+};
+
+} // namespace networkStructure
+
+#endif // PARTITION_H
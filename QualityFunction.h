@@ -0,0 +1,158 @@
+#ifndef QUALITYFUNCTION_H
+#define QUALITYFUNCTION_H
+
+#include "GainKernel.h"
+
+#include <string>
+
+namespace networkStructure {
+
+/**
+ * @enum QualityType
+ * @brief Función de calidad que optimizan los algoritmos de Algoritmo.
+ * @details Solo se consulta una vez por llamada, para elegir la versión especializada del algoritmo; dentro
+ * de los bucles de evaluación la función está fijada en tiempo de compilación (ver CPMQuality).
+ */
+enum class QualityType {
+    CPM,        ///< Constant Potts Model con tamaños de nodo (por defecto).
+    MODULARITY, ///< Modularidad de Newman con resolución gamma (Reichardt-Bornholdt con modelo de configuración).
+    RBER        ///< Reichardt-Bornholdt con modelo nulo de Erdős-Rényi.
+};
+
+/**
+ * @struct CPMQuality
+ * @brief Política de calidad del Constant Potts Model: Q = Σ_c (w_c - gamma * n_c * (n_c - 1) / 2).
+ * @details Todas las políticas tienen la misma interfaz y se pasan como parámetro de plantilla, de modo que
+ * cada algoritmo se compila una vez por función de calidad con la ganancia en línea (sin llamadas virtuales
+ * ni comprobaciones en el bucle interno). Para dos grupos disjuntos de nodos A y B:
+ *  - expected(): peso esperado entre ellos según el modelo nulo (n = nº de nodos originales, k = grado).
+ *  - gain(): ΔQ de mover un nodo i (tamaño n_i, grado k_i) de su comunidad (tamaño size_i y grado total tot_i,
+ *    contándolo a él) a otra (size_j, tot_j), es decir (k_i_in_j - k_i_in_i) - expected(i, j) + expected(i, i - {i}).
+ *  - penalty(): término que se resta al peso interno w_c de una comunidad en la calidad total.
+ *  - linearGain(): los coeficientes de gain() como función lineal de (k_i_in_j, size_j, tot_j), para evaluar
+ *    todas las comunidades candidatas de un nodo con una sola reducción vectorial (ver bestCandidate()).
+ *
+ * Todas expresan la calidad en unidades de peso de arista, como el CPM, para que min_gain tenga el mismo
+ * significado con cualquier función.
+ */
+struct CPMQuality {
+    double gamma;
+
+    /**
+     * @param gamma Parámetro de resolución.
+     * @param total_weight Suma de todos los grados (2m).
+     * @param total_size Nº total de nodos originales.
+     */
+    CPMQuality(double gamma, double /*total_weight*/, double /*total_size*/) : gamma(gamma) {}
+
+    double expected(double n_a, double /*k_a*/, double n_b, double /*k_b*/) const {
+        return gamma * n_a * n_b;
+    }
+    double gain(double k_i_in_j, double k_i_in_i, double n_i, double /*k_i*/, double size_i, double /*tot_i*/,
+                double size_j, double /*tot_j*/) const {
+        return (k_i_in_j - k_i_in_i) + gamma * n_i * (size_i - n_i - size_j);
+    }
+    LinearGain linearGain(double k_i_in_i, double n_i, double /*k_i*/, double size_i, double /*tot_i*/) const {
+        LinearGain g;
+        g.alpha = gamma * n_i;
+        g.offset = gamma * n_i * (size_i - n_i) - k_i_in_i;
+        return g;
+    }
+    double penalty(double n_c, double /*tot_c*/) const {
+        return gamma * n_c * (n_c - 1.0) / 2.0;
+    }
+};
+
+/**
+ * @struct ModularityQuality
+ * @brief Política de modularidad con resolución: Q = Σ_c (w_c - gamma * K_c^2 / (4m)), con K_c el grado total.
+ * @details Es la modularidad de Newman multiplicada por m; con gamma != 1 coincide con la función de
+ * Reichardt-Bornholdt con modelo nulo de configuración.
+ */
+struct ModularityQuality {
+    double scale; ///< gamma / 2m.
+
+    ModularityQuality(double gamma, double total_weight, double /*total_size*/)
+        : scale(total_weight > 0.0 ? gamma / total_weight : 0.0) {}
+
+    double expected(double /*n_a*/, double k_a, double /*n_b*/, double k_b) const {
+        return scale * k_a * k_b;
+    }
+    double gain(double k_i_in_j, double k_i_in_i, double /*n_i*/, double k_i, double /*size_i*/, double tot_i,
+                double /*size_j*/, double tot_j) const {
+        return (k_i_in_j - k_i_in_i) - scale * k_i * (tot_j - tot_i + k_i);
+    }
+    LinearGain linearGain(double k_i_in_i, double /*n_i*/, double k_i, double /*size_i*/, double tot_i) const {
+        LinearGain g;
+        g.beta = scale * k_i;
+        g.offset = scale * k_i * (tot_i - k_i) - k_i_in_i;
+        return g;
+    }
+    double penalty(double /*n_c*/, double tot_c) const {
+        return 0.5 * scale * tot_c * tot_c;
+    }
+};
+
+/**
+ * @struct RBERQuality
+ * @brief Política de Reichardt-Bornholdt con modelo nulo de Erdős-Rényi: Q = Σ_c (w_c - gamma * p * n_c * (n_c - 1) / 2).
+ * @details p = m / (n (n - 1) / 2) es la densidad de la red, así que equivale al CPM con resolución gamma * p:
+ * gamma = 1 compara cada comunidad con la densidad media de la red.
+ */
+struct RBERQuality {
+    double gamma_p; ///< gamma * densidad.
+
+    RBERQuality(double gamma, double total_weight, double total_size)
+        : gamma_p(total_size > 1.0 ? gamma * total_weight / (total_size * (total_size - 1.0)) : 0.0) {}
+
+    double expected(double n_a, double /*k_a*/, double n_b, double /*k_b*/) const {
+        return gamma_p * n_a * n_b;
+    }
+    double gain(double k_i_in_j, double k_i_in_i, double n_i, double /*k_i*/, double size_i, double /*tot_i*/,
+                double size_j, double /*tot_j*/) const {
+        return (k_i_in_j - k_i_in_i) + gamma_p * n_i * (size_i - n_i - size_j);
+    }
+    LinearGain linearGain(double k_i_in_i, double n_i, double /*k_i*/, double size_i, double /*tot_i*/) const {
+        LinearGain g;
+        g.alpha = gamma_p * n_i;
+        g.offset = gamma_p * n_i * (size_i - n_i) - k_i_in_i;
+        return g;
+    }
+    double penalty(double n_c, double /*tot_c*/) const {
+        return gamma_p * n_c * (n_c - 1.0) / 2.0;
+    }
+};
+
+/**
+ * @brief Nombre de una función de calidad ("cpm", "modularity" o "rber").
+ */
+inline const char* qualityName(QualityType type) {
+    switch (type) {
+    case QualityType::MODULARITY: return "modularity";
+    case QualityType::RBER:       return "rber";
+    default:                      return "cpm";
+    }
+}
+
+/**
+ * @brief Interpreta el nombre de una función de calidad (ver qualityName()).
+ * @param name Nombre a interpretar.
+ * @param type Función de calidad correspondiente.
+ * @return true si el nombre es válido, false en caso contrario.
+ */
+inline bool parseQualityType(const std::string& name, QualityType& type) {
+    if (name == "cpm") {
+        type = QualityType::CPM;
+    } else if (name == "modularity") {
+        type = QualityType::MODULARITY;
+    } else if (name == "rber") {
+        type = QualityType::RBER;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+} // namespace networkStructure
+
+#endif // QUALITYFUNCTION_H
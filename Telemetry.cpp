@@ -0,0 +1,154 @@
+#include "Telemetry.h"
+
+#include <fstream>
+#include <iostream>
+#include <limits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+namespace networkStructure {
+
+void Telemetry::reset() {
+    for (auto& counter : counters) counter.store(0, std::memory_order_relaxed);
+    for (double& t : times) t = 0.0;
+    runs = 0;
+    sweeps.clear();
+    thread_stats.clear();
+}
+
+void Telemetry::recordThreadStats(const std::vector<WorkScheduler::ThreadStats>& stats) {
+    if constexpr (TELEMETRY_ENABLED) {
+        if (thread_stats.size() < stats.size()) thread_stats.resize(stats.size());
+        for (std::size_t t = 0; t < stats.size(); ++t) {
+            thread_stats[t].busy_time += stats[t].busy_time;
+            thread_stats[t].idle_time += stats[t].idle_time;
+            thread_stats[t].chunks += stats[t].chunks;
+            thread_stats[t].stolen += stats[t].stolen;
+        }
+    }
+}
+
+std::size_t Telemetry::getPeakMemoryBytes() {
+#if defined(__unix__) || defined(__APPLE__)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#if defined(__APPLE__)
+    return static_cast<std::size_t>(usage.ru_maxrss); // en bytes
+#else
+    return static_cast<std::size_t>(usage.ru_maxrss) * 1024; // en KiB
+#endif
+#else
+    return 0;
+#endif
+}
+
+const char* Telemetry::counterName(Counter counter) {
+    switch (counter) {
+    case Counter::SWEEPS:          return "sweeps";
+    case Counter::NODES_EVALUATED: return "nodes_evaluated";
+    case Counter::DQ_EVALUATIONS:  return "dq_evaluations";
+    case Counter::MOVES_PROPOSED:  return "moves_proposed";
+    case Counter::MOVES_APPLIED:   return "moves_applied";
+    case Counter::MOVES_REJECTED:  return "moves_rejected";
+    case Counter::MERGES:          return "merges";
+    case Counter::MERGED_NODES:    return "merged_nodes";
+    case Counter::EDGES_LOADED:    return "edges_loaded";
+    default:                       return "unknown";
+    }
+}
+
+const char* Telemetry::phaseName(Phase phase) {
+    switch (phase) {
+    case Phase::LOAD_PARSE:  return "load_parse";
+    case Phase::LOAD_IDS:    return "load_ids";
+    case Phase::LOAD_INSERT: return "load_insert";
+    case Phase::REBUILD:     return "rebuild";
+    case Phase::PARALLEL:    return "parallel";
+    case Phase::APPLY:       return "apply";
+    case Phase::MERGE:       return "merge";
+    default:                 return "unknown";
+    }
+}
+
+void Telemetry::writeJSON(std::ostream& out) const {
+    out.precision(std::numeric_limits<double>::max_digits10);
+    out << "{\n  \"telemetry_enabled\": " << (TELEMETRY_ENABLED ? "true" : "false") << ",\n";
+    out << "  \"peak_memory_bytes\": " << getPeakMemoryBytes() << ",\n";
+    out << "  \"runs\": " << runs << ",\n";
+    out << "  \"counters\": {";
+    for (int c = 0; c < static_cast<int>(Counter::COUNT); ++c) {
+        out << (c ? ", " : "") << '"' << counterName(static_cast<Counter>(c)) << "\": " << get(static_cast<Counter>(c));
+    }
+    out << "},\n  \"phases_s\": {";
+    for (int p = 0; p < static_cast<int>(Phase::COUNT); ++p) {
+        out << (p ? ", " : "") << '"' << phaseName(static_cast<Phase>(p)) << "\": " << times[p];
+    }
+    out << "},\n  \"threads\": [";
+    for (std::size_t t = 0; t < thread_stats.size(); ++t) {
+        const WorkScheduler::ThreadStats& st = thread_stats[t];
+        out << (t ? ",\n    " : "\n    ") << "{\"thread\": " << t << ", \"busy_s\": " << st.busy_time
+            << ", \"idle_s\": " << st.idle_time << ", \"chunks\": " << st.chunks << ", \"stolen\": " << st.stolen << "}";
+    }
+    out << (thread_stats.empty() ? "" : "\n  ") << "],\n  \"sweeps\": [";
+    for (std::size_t s = 0; s < sweeps.size(); ++s) {
+        const SweepRecord& r = sweeps[s];
+        out << (s ? ",\n    " : "\n    ") << "{\"run\": " << r.run << ", \"sweep\": " << r.sweep << ", \"active\": "
+            << r.active << ", \"moves\": " << r.moves << ", \"quality\": " << r.quality << ", \"seconds\": "
+            << r.seconds << "}";
+    }
+    out << (sweeps.empty() ? "" : "\n  ") << "]\n}\n";
+}
+
+void Telemetry::writeCSV(std::ostream& out) const {
+    out.precision(std::numeric_limits<double>::max_digits10);
+    out << "metric,value\n";
+    out << "telemetry_enabled," << (TELEMETRY_ENABLED ? 1 : 0) << '\n';
+    out << "peak_memory_bytes," << getPeakMemoryBytes() << '\n';
+    out << "runs," << runs << '\n';
+    for (int c = 0; c < static_cast<int>(Counter::COUNT); ++c) {
+        out << "counters." << counterName(static_cast<Counter>(c)) << ',' << get(static_cast<Counter>(c)) << '\n';
+    }
+    for (int p = 0; p < static_cast<int>(Phase::COUNT); ++p) {
+        out << "phases." << phaseName(static_cast<Phase>(p)) << "_s," << times[p] << '\n';
+    }
+    for (std::size_t t = 0; t < thread_stats.size(); ++t) {
+        const WorkScheduler::ThreadStats& st = thread_stats[t];
+        out << "threads." << t << ".busy_s," << st.busy_time << '\n';
+        out << "threads." << t << ".idle_s," << st.idle_time << '\n';
+        out << "threads." << t << ".chunks," << st.chunks << '\n';
+        out << "threads." << t << ".stolen," << st.stolen << '\n';
+    }
+    for (std::size_t s = 0; s < sweeps.size(); ++s) {
+        const SweepRecord& r = sweeps[s];
+        out << "sweeps." << s << ".run," << r.run << '\n';
+        out << "sweeps." << s << ".sweep," << r.sweep << '\n';
+        out << "sweeps." << s << ".active," << r.active << '\n';
+        out << "sweeps." << s << ".moves," << r.moves << '\n';
+        out << "sweeps." << s << ".quality," << r.quality << '\n';
+        out << "sweeps." << s << ".seconds," << r.seconds << '\n';
+    }
+}
+
+bool Telemetry::writeReport(const std::string& filename) const {
+    std::ofstream out(filename, std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "Error: No se pudo crear el archivo " << filename << std::endl;
+        return false;
+    }
+    bool csv = filename.size() >= 4 && filename.compare(filename.size() - 4, 4, ".csv") == 0;
+    if (csv) {
+        writeCSV(out);
+    } else {
+        writeJSON(out);
+    }
+    out.flush();
+    if (!out) {
+        std::cerr << "Error: Fallo al escribir el archivo " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace networkStructure
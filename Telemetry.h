@@ -0,0 +1,224 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "WorkScheduler.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <omp.h>
+
+// Con CD_TELEMETRY=0 (opción CD_ENABLE_TELEMETRY=OFF de CMake) contadores y temporizadores no hacen nada
+// y el compilador elimina su coste; el informe se sigue pudiendo escribir, con todo a cero.
+#ifndef CD_TELEMETRY
+#define CD_TELEMETRY 1
+#endif
+
+namespace networkStructure {
+
+constexpr bool TELEMETRY_ENABLED = CD_TELEMETRY != 0; ///< Instrumentación compilada.
+
+/**
+ * @enum Counter
+ * @brief Contadores que acumula Telemetry.
+ */
+enum class Counter {
+    SWEEPS,          ///< Barridos de run().
+    NODES_EVALUATED, ///< Nodos evaluados en los barridos.
+    DQ_EVALUATIONS,  ///< Comunidades candidatas evaluadas (cálculos de ΔQ).
+    MOVES_PROPOSED,  ///< Movimientos propuestos por los hilos.
+    MOVES_APPLIED,   ///< Movimientos aplicados.
+    MOVES_REJECTED,  ///< Propuestas descartadas al revalidar su ΔQ (modo BATCH).
+    MERGES,          ///< Agregaciones de la red (mergeCommunities() y niveles de runMultilevel()).
+    MERGED_NODES,    ///< Nodos eliminados al agregar (nodos antes - supernodos después).
+    EDGES_LOADED,    ///< Aristas leídas por el cargador.
+    COUNT            ///< Nº de contadores (no es un contador).
+};
+
+/**
+ * @enum Phase
+ * @brief Fases con tiempo acumulado en Telemetry.
+ */
+enum class Phase {
+    LOAD_PARSE,  ///< Lectura del CSV.
+    LOAD_IDS,    ///< Traducción de IDs externos a densos.
+    LOAD_INSERT, ///< Inserción de las aristas en la Network.
+    REBUILD,     ///< Preparación de run(): partición, tamaños, grados y agregados por comunidad.
+    PARALLEL,    ///< Región paralela de evaluación de los barridos.
+    APPLY,       ///< Aplicación de movimientos (revalidación en BATCH, mejor global en SPLICE).
+    MERGE,       ///< Construcción de la red agregada.
+    COUNT        ///< Nº de fases (no es una fase).
+};
+
+/**
+ * @class Telemetry
+ * @brief Métricas de ejecución (contadores, tiempo por fase, calidad por barrido, carga por hilo y memoria
+ * máxima) con informe en JSON o CSV.
+ * @details Los algoritmos y el cargador reciben un puntero opcional (nullptr = sin métricas). Los contadores
+ * son atómicos, pero los bucles paralelos acumulan en variables locales y suman una vez por hilo y barrido;
+ * los tiempos y el resto de registros solo se actualizan fuera de las regiones paralelas.
+ */
+class Telemetry {
+public:
+    /**
+     * @struct SweepRecord
+     * @brief Estado tras un barrido de run().
+     */
+    struct SweepRecord {
+        unsigned int run = 0;       ///< Nº de llamada a run() (desde 1).
+        unsigned int sweep = 0;     ///< Nº de barrido dentro de la llamada (desde 1).
+        std::size_t active = 0;     ///< Nodos evaluados en el barrido.
+        std::size_t moves = 0;      ///< Movimientos aplicados.
+        double quality = 0.0;       ///< Calidad de la partición al terminar el barrido.
+        double seconds = 0.0;       ///< Duración del barrido.
+    };
+
+    Telemetry() { reset(); }
+    Telemetry(const Telemetry&) = delete;
+    Telemetry& operator=(const Telemetry&) = delete;
+
+    /**
+     * @brief Pone a cero todas las métricas.
+     */
+    void reset();
+
+    /**
+     * @brief Suma a un contador (seguro entre hilos).
+     */
+    void add(Counter counter, std::uint64_t value = 1) {
+        if constexpr (TELEMETRY_ENABLED) {
+            counters[static_cast<int>(counter)].fetch_add(value, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Suma segundos al tiempo de una fase.
+     */
+    void addTime(Phase phase, double seconds) {
+        if constexpr (TELEMETRY_ENABLED) {
+            times[static_cast<int>(phase)] += seconds;
+        }
+    }
+
+    /**
+     * @brief Empieza una nueva llamada a run() y devuelve su número (desde 1).
+     */
+    unsigned int beginRun() { return ++runs; }
+
+    /**
+     * @brief Registra el estado tras un barrido.
+     */
+    void recordSweep(const SweepRecord& record) {
+        if constexpr (TELEMETRY_ENABLED) {
+            sweeps.push_back(record);
+        }
+    }
+
+    /**
+     * @brief Acumula el tiempo ocupado/inactivo y los bloques de cada hilo de una llamada a run().
+     */
+    void recordThreadStats(const std::vector<WorkScheduler::ThreadStats>& stats);
+
+    /**
+     * @brief Devuelve el valor de un contador.
+     */
+    std::uint64_t get(Counter counter) const { return counters[static_cast<int>(counter)].load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Devuelve los segundos acumulados en una fase.
+     */
+    double getTime(Phase phase) const { return times[static_cast<int>(phase)]; }
+
+    /**
+     * @brief Devuelve el estado tras cada barrido registrado, en orden.
+     */
+    const std::vector<SweepRecord>& getSweeps() const { return sweeps; }
+
+    /**
+     * @brief Devuelve la carga acumulada de cada hilo.
+     */
+    const std::vector<WorkScheduler::ThreadStats>& getThreadStats() const { return thread_stats; }
+
+    /**
+     * @brief Instante actual en segundos (omp_get_wtime()), o 0 sin instrumentación compilada.
+     */
+    static double now() {
+        if constexpr (TELEMETRY_ENABLED) {
+            return omp_get_wtime();
+        }
+        return 0.0;
+    }
+
+    /**
+     * @brief Memoria residente máxima del proceso hasta ahora, en bytes (0 si el sistema no la proporciona).
+     */
+    static std::size_t getPeakMemoryBytes();
+
+    /**
+     * @brief Nombre de un contador o fase en el informe ("sweeps", "parallel", ...).
+     */
+    static const char* counterName(Counter counter);
+    static const char* phaseName(Phase phase);
+
+    /**
+     * @brief Escribe el informe como un objeto JSON.
+     */
+    void writeJSON(std::ostream& out) const;
+
+    /**
+     * @brief Escribe el informe como CSV de dos columnas (metric,value) con las mismas claves que el JSON
+     * aplanadas con puntos (counters.sweeps, phases.parallel_s, threads.0.busy_s, sweeps.3.quality, ...).
+     */
+    void writeCSV(std::ostream& out) const;
+
+    /**
+     * @brief Escribe el informe en un fichero: CSV si el nombre termina en ".csv" y JSON en otro caso.
+     * @return true si se pudo escribir, false en caso contrario.
+     */
+    bool writeReport(const std::string& filename) const;
+
+private:
+    std::atomic<std::uint64_t> counters[static_cast<int>(Counter::COUNT)];
+    double times[static_cast<int>(Phase::COUNT)];
+    unsigned int runs = 0;
+    std::vector<SweepRecord> sweeps;
+    std::vector<WorkScheduler::ThreadStats> thread_stats;
+};
+
+/**
+ * @class ScopedTimer
+ * @brief Suma a una fase de Telemetry el tiempo que vive el objeto (nada si telemetry es nullptr).
+ */
+class ScopedTimer {
+public:
+    ScopedTimer(Telemetry* telemetry, Phase phase) : telemetry(telemetry), phase(phase) {
+        if constexpr (TELEMETRY_ENABLED) {
+            if (telemetry) start = omp_get_wtime();
+        }
+    }
+    ~ScopedTimer() { stop(); }
+
+    /**
+     * @brief Suma ya el tiempo transcurrido (para fases que no coinciden con un bloque); después no hace nada.
+     */
+    void stop() {
+        if constexpr (TELEMETRY_ENABLED) {
+            if (telemetry) telemetry->addTime(phase, omp_get_wtime() - start);
+        }
+        telemetry = nullptr;
+    }
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    Telemetry* telemetry;
+    Phase phase;
+    double start = 0.0;
+};
+
+} // namespace networkStructure
+
+#endif // TELEMETRY_H
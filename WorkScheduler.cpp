@@ -0,0 +1,137 @@
+#include "WorkScheduler.h"
+#include <omp.h>
+
+namespace networkStructure {
+
+namespace {
+inline std::uint64_t packRange(std::uint32_t head, std::uint32_t tail) {
+    return (static_cast<std::uint64_t>(head) << 32) | tail;
+}
+} // namespace
+
+WorkScheduler::WorkScheduler(const std::vector<std::size_t>& costs, int n_threads_, int chunks_per_thread_)
+    : n_threads(n_threads_ < 1 ? 1 : n_threads_), chunks_per_thread(chunks_per_thread_ < 1 ? 1 : chunks_per_thread_) {
+    slots.reset(new ThreadSlot[n_threads]);
+    assign(costs);
+}
+
+void WorkScheduler::assign(const std::vector<std::size_t>& costs) {
+    chunks.clear();
+    int n = static_cast<int>(costs.size());
+    double total_cost = 0.0;
+    for (std::size_t c : costs) total_cost += static_cast<double>(c);
+
+    // Bloques contiguos de coste ~target; un nodo muy caro forma su propio bloque
+    double target = total_cost / (static_cast<double>(n_threads) * chunks_per_thread);
+    std::vector<double> chunk_start_cost; // coste acumulado al inicio de cada bloque
+    double acc = 0.0;
+    double current = 0.0;
+    int begin = 0;
+    for (int i = 0; i < n; ++i) {
+        double c = static_cast<double>(costs[i]);
+        if (i > begin && current + c > target) {
+            chunks.push_back({begin, i});
+            chunk_start_cost.push_back(acc - current);
+            begin = i;
+            current = 0.0;
+        }
+        current += c;
+        acc += c;
+    }
+    if (begin < n) {
+        chunks.push_back({begin, n});
+        chunk_start_cost.push_back(acc - current);
+    }
+
+    // Reparto inicial: el hilo t recibe los bloques cuyo inicio cae en su fracción t/P del coste total,
+    // de modo que cada cola es un rango contiguo de bloques (y de nodos).
+    std::uint32_t next_chunk = 0;
+    for (int t = 0; t < n_threads; ++t) {
+        double limit = total_cost * static_cast<double>(t + 1) / n_threads;
+        slots[t].first = next_chunk;
+        while (next_chunk < chunks.size() && (t == n_threads - 1 || chunk_start_cost[next_chunk] < limit)) {
+            ++next_chunk;
+        }
+        slots[t].last = next_chunk;
+    }
+}
+
+void WorkScheduler::beginSweep() {
+    for (int t = 0; t < n_threads; ++t) {
+        slots[t].range.store(packRange(slots[t].first, slots[t].last), std::memory_order_relaxed);
+        slots[t].in_chunk = false;
+        slots[t].sweep_busy = 0.0;
+    }
+    sweep_start = omp_get_wtime();
+}
+
+void WorkScheduler::endSweep() {
+    double elapsed = omp_get_wtime() - sweep_start;
+    for (int t = 0; t < n_threads; ++t) {
+        double idle = elapsed - slots[t].sweep_busy;
+        if (idle > 0.0) slots[t].stats.idle_time += idle;
+    }
+}
+
+bool WorkScheduler::popOwn(int tid, WorkChunk& chunk) {
+    std::atomic<std::uint64_t>& range = slots[tid].range;
+    std::uint64_t r = range.load(std::memory_order_acquire);
+    while (true) {
+        std::uint32_t head = static_cast<std::uint32_t>(r >> 32);
+        std::uint32_t tail = static_cast<std::uint32_t>(r);
+        if (head >= tail) return false;
+        if (range.compare_exchange_weak(r, packRange(head + 1, tail), std::memory_order_acq_rel)) {
+            chunk = chunks[head];
+            return true;
+        }
+    }
+}
+
+bool WorkScheduler::steal(int tid, WorkChunk& chunk) {
+    for (int k = 1; k < n_threads; ++k) {
+        int victim = (tid + k) % n_threads;
+        std::atomic<std::uint64_t>& range = slots[victim].range;
+        std::uint64_t r = range.load(std::memory_order_acquire);
+        while (true) {
+            std::uint32_t head = static_cast<std::uint32_t>(r >> 32);
+            std::uint32_t tail = static_cast<std::uint32_t>(r);
+            if (head >= tail) break; // cola vacía: probamos con el siguiente hilo
+            if (range.compare_exchange_weak(r, packRange(head, tail - 1), std::memory_order_acq_rel)) {
+                chunk = chunks[tail - 1];
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool WorkScheduler::next(int tid, WorkChunk& chunk) {
+    ThreadSlot& slot = slots[tid];
+    double now = omp_get_wtime();
+    if (slot.in_chunk) {
+        slot.sweep_busy += now - slot.chunk_start;
+        slot.stats.busy_time += now - slot.chunk_start;
+        slot.in_chunk = false;
+    }
+    bool found = popOwn(tid, chunk);
+    if (!found && steal(tid, chunk)) {
+        found = true;
+        ++slot.stats.stolen;
+    }
+    if (found) {
+        ++slot.stats.chunks;
+        slot.in_chunk = true;
+        slot.chunk_start = omp_get_wtime();
+    }
+    return found;
+}
+
+std::vector<WorkScheduler::ThreadStats> WorkScheduler::getStats() const {
+    std::vector<ThreadStats> stats(n_threads);
+    for (int t = 0; t < n_threads; ++t) {
+        stats[t] = slots[t].stats;
+    }
+    return stats;
+}
+
+} // namespace networkStructure
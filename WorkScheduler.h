@@ -0,0 +1,128 @@
+#ifndef WORKSCHEDULER_H
+#define WORKSCHEDULER_H
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace networkStructure {
+
+/**
+ * @struct WorkChunk
+ * @brief Bloque de trabajo: rango semiabierto [begin, end) de índices de nodo.
+ */
+struct WorkChunk {
+    int begin = 0; ///< Primer índice del bloque.
+    int end = 0;   ///< Índice siguiente al último (no incluido).
+};
+
+/**
+ * @class WorkScheduler
+ * @brief Planificador por bloques con robo de trabajo (work stealing) para los barridos paralelos.
+ * @details Los nodos se dividen en bloques contiguos de coste parecido (el coste de un nodo es su nº de
+ * aristas más uno) y los bloques se reparten, también por coste, entre las colas de los hilos. Cada hilo
+ * consume su cola por delante y, cuando se vacía, roba bloques del final de las colas de los demás. Así el
+ * reparto se corrige durante el barrido aunque el coste real de evaluar un nodo (que depende del nº de
+ * comunidades vecinas distintas) se aleje del grado. Cada cola es un par (cabeza, cola) de índices de
+ * bloque empaquetado en un entero atómico de 64 bits, por lo que tomar o robar un bloque es un único CAS.
+ *
+ * Los bloques son rangos semiabiertos que cubren todos los nodos, por lo que ningún nodo se queda sin
+ * procesar. También mide, por hilo, el tiempo ocupado (procesando bloques) e inactivo (esperando al resto).
+ */
+class WorkScheduler {
+public:
+    /**
+     * @struct ThreadStats
+     * @brief Estadísticas acumuladas de un hilo.
+     */
+    struct ThreadStats {
+        double busy_time = 0.0;   ///< Segundos procesando bloques.
+        double idle_time = 0.0;   ///< Segundos sin trabajo dentro de los barridos.
+        unsigned long chunks = 0; ///< Bloques procesados.
+        unsigned long stolen = 0; ///< Bloques robados a otros hilos.
+    };
+
+private:
+    // Estado de cada hilo, alineado a una línea de caché para evitar falsa compartición
+    struct alignas(64) ThreadSlot {
+        std::atomic<std::uint64_t> range{0}; // (cabeza << 32) | cola, sobre el vector 'chunks'
+        std::uint32_t first = 0;             // rango inicial de bloques del hilo
+        std::uint32_t last = 0;
+        double chunk_start = 0.0;            // instante en que empezó el bloque en curso
+        bool in_chunk = false;
+        double sweep_busy = 0.0;             // tiempo ocupado en el barrido actual
+        ThreadStats stats;
+    };
+
+    std::vector<WorkChunk> chunks;         ///< Bloques en orden de índice de nodo.
+    std::unique_ptr<ThreadSlot[]> slots;   ///< Cola y estadísticas de cada hilo.
+    int n_threads = 1;                     ///< Nº de colas.
+    int chunks_per_thread = 1;             ///< Nº aproximado de bloques por hilo.
+    double sweep_start = 0.0;              ///< Instante de inicio del barrido en curso.
+
+    bool popOwn(int tid, WorkChunk& chunk);
+    bool steal(int tid, WorkChunk& chunk);
+
+public:
+    static const int CHUNKS_PER_THREAD = 16; ///< Bloques por hilo: equilibrio entre reparto y coste del CAS.
+
+    /**
+     * @brief Construye los bloques y el reparto inicial entre hilos.
+     * @param costs Coste estimado de cada nodo (por ejemplo, su nº de aristas más uno).
+     * @param n_threads Nº de hilos que consumirán los bloques.
+     * @param chunks_per_thread Nº aproximado de bloques por hilo.
+     */
+    WorkScheduler(const std::vector<std::size_t>& costs, int n_threads, int chunks_per_thread = CHUNKS_PER_THREAD);
+
+    WorkScheduler(const WorkScheduler&) = delete;
+    WorkScheduler& operator=(const WorkScheduler&) = delete;
+
+    /**
+     * @brief Rehace los bloques y el reparto para una nueva lista de costes, conservando las estadísticas.
+     * @details Permite barrer en cada iteración un subconjunto distinto de nodos (por ejemplo, solo los
+     * activos). Debe llamarse fuera de la región paralela, antes de beginSweep().
+     * @param costs Coste estimado de cada elemento; los bloques son rangos de posiciones de este vector.
+     */
+    void assign(const std::vector<std::size_t>& costs);
+
+    /**
+     * @brief Rellena las colas con el reparto inicial y empieza a medir un barrido.
+     * @details Debe llamarse fuera de la región paralela, antes de cada barrido.
+     */
+    void beginSweep();
+
+    /**
+     * @brief Cierra el barrido: el tiempo del barrido no ocupado cuenta como inactivo en cada hilo.
+     * @details Debe llamarse fuera de la región paralela, después de su barrera final.
+     */
+    void endSweep();
+
+    /**
+     * @brief Devuelve el siguiente bloque del hilo, de su cola o robado a otro.
+     * @param tid Nº del hilo (omp_get_thread_num()).
+     * @param chunk Bloque asignado.
+     * @return false si ya no queda ningún bloque en el barrido.
+     */
+    bool next(int tid, WorkChunk& chunk);
+
+    /**
+     * @brief Nº de colas (hilos) del planificador.
+     */
+    int getNThreads() const { return n_threads; }
+
+    /**
+     * @brief Nº total de bloques.
+     */
+    std::size_t getNChunks() const { return chunks.size(); }
+
+    /**
+     * @brief Estadísticas acumuladas de cada hilo.
+     */
+    std::vector<ThreadStats> getStats() const;
+};
+
+} // namespace networkStructure
+
+#endif // WORKSCHEDULER_H
@@ -0,0 +1,155 @@
+/**
+ * @file BenchAcumulador.cpp
+ * @brief Micro-benchmark del cálculo de pesos hacia comunidades vecinas en nodos de grado alto.
+ * @details Compara el método anterior (un std::map<int,double> nuevo por nodo) con NeighborAccumulator
+ * (vector denso + lista de claves tocadas reutilizados). Para cada grado construye una red en estrella con
+ * varios nodos hub cuyos vecinos están repartidos aleatoriamente en comunidades, y mide cuántos nodos hub
+ * por segundo procesa cada método (acumulación + búsqueda del mejor ΔQ con CPMQuality::gain(), con el
+ * tamaño y el grado total de cada comunidad, como en el movimiento local).
+ *
+ * Compilación: objetivo bench_acumulador del CMakeLists.txt, o a mano desde la raíz del repositorio:
+ *   g++ -std=c++17 -O2 -fopenmp -I. benchmarks/BenchAcumulador.cpp Network.cpp Node.cpp Edge.cpp NeighborAccumulator.cpp -o bench_acumulador
+ */
+#include "Network.h"
+#include "Node.h"
+#include "Edge.h"
+#include "NeighborAccumulator.h"
+#include "QualityFunction.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace networkStructure;
+
+namespace {
+
+// Comunidad de cada nodo (indexada por ID, como en Partition) con su tamaño y grado total
+struct Comunidades {
+    std::vector<int> of;
+    std::vector<double> size; ///< Nº de nodos originales de cada comunidad.
+    std::vector<double> tot;  ///< Suma de los grados de sus nodos.
+};
+
+// ΔQ de mover el hub, solo en su comunidad, a la comunidad vecina comm
+double ganancia(const CPMQuality& quality, Node* hub, const Comunidades& comms, int comm, double k_i_in_j) {
+    int own = comms.of[hub->getID()];
+    double n_i = static_cast<double>(hub->getSize());
+    double k_i = comms.tot[own];
+    return quality.gain(k_i_in_j, 0.0, n_i, k_i, comms.size[own], k_i, comms.size[comm], comms.tot[comm]);
+}
+
+// Método anterior: un mapa nuevo por nodo
+double evaluarConMapa(Node* hub, const Comunidades& comms, const CPMQuality& quality) {
+    std::map<int, double> weights;
+    for (Edge* edge : hub->getAdjList()) {
+        Node* neighbor = edge->getOpposite(hub);
+        weights[comms.of[neighbor->getID()]] += edge->getWeight();
+    }
+    double best = 0.0;
+    for (const auto& entry : weights) {
+        double dQ = ganancia(quality, hub, comms, entry.first, entry.second);
+        if (dQ > best) best = dQ;
+    }
+    return best;
+}
+
+// Método nuevo: acumulador reutilizado
+double evaluarConAcumulador(Node* hub, const Comunidades& comms, const CPMQuality& quality,
+                            NeighborAccumulator& weights) {
+    weights.clear();
+    for (Edge* edge : hub->getAdjList()) {
+        Node* neighbor = edge->getOpposite(hub);
+        weights.add(comms.of[neighbor->getID()], edge->getWeight());
+    }
+    double best = 0.0;
+    for (int comm : weights.getKeys()) {
+        double dQ = ganancia(quality, hub, comms, comm, weights.get(comm));
+        if (dQ > best) best = dQ;
+    }
+    return best;
+}
+
+} // namespace
+
+int main() {
+    const int hubs = 16;
+    const int repeticiones = 20;
+    const double gamma = 0.001;
+    const std::vector<unsigned int> grados = {1000, 10000, 50000};
+    const std::vector<unsigned int> comunidades_por_grado = {10, 100}; // grado / nº de comunidades vecinas
+
+    std::cout << std::left << std::setw(10) << "Grado" << std::setw(14) << "Comunidades"
+              << std::setw(18) << "map (nodos/s)" << std::setw(22) << "acumulador (nodos/s)"
+              << "Aceleracion" << std::endl;
+
+    for (unsigned int grado : grados) {
+        for (unsigned int ratio : comunidades_por_grado) {
+            unsigned int n_comms = grado / ratio;
+            std::mt19937 rng(12345u + grado + ratio);
+            std::uniform_int_distribution<unsigned int> comm_dist(0, n_comms - 1);
+
+            // Los hubs tienen IDs 0..hubs-1 y las hojas a partir de 'hubs'. La comunidad de cada nodo
+            // se guarda en un vector indexado por ID, como en Partition.
+            Network network;
+            network.reserve(static_cast<std::size_t>(hubs) * (grado + 1), static_cast<std::size_t>(hubs) * grado);
+            Comunidades comms;
+            comms.of.resize(static_cast<std::size_t>(hubs) * (grado + 1));
+            unsigned int next_id = hubs;
+            for (unsigned int h = 0; h < static_cast<unsigned int>(hubs); ++h) {
+                network.addNode(h);
+                comms.of[h] = static_cast<int>(n_comms + h);
+                for (unsigned int k = 0; k < grado; ++k) {
+                    unsigned int leaf = next_id++;
+                    network.addEdge(h, leaf, 1.0);
+                    comms.of[leaf] = static_cast<int>(comm_dist(rng));
+                }
+            }
+            comms.size.assign(n_comms + hubs, 0.0);
+            comms.tot.assign(n_comms + hubs, 0.0);
+            double total_weight = 0.0;
+            for (const auto& ptr : network.getNodes()) {
+                if (ptr) comms.size[comms.of[ptr->getID()]] += ptr->getSize();
+            }
+            for (const auto& ptr : network.getEdges()) {
+                comms.tot[comms.of[ptr->getOrigin()->getID()]] += ptr->getWeight();
+                comms.tot[comms.of[ptr->getDestiny()->getID()]] += ptr->getWeight();
+                total_weight += 2.0 * ptr->getWeight();
+            }
+            CPMQuality quality(gamma, total_weight, static_cast<double>(network.getNNodes()));
+            std::vector<Node*> hub_nodes;
+            for (unsigned int h = 0; h < static_cast<unsigned int>(hubs); ++h) {
+                hub_nodes.push_back(network.getNode(h));
+            }
+
+            double sink = 0.0;
+            auto t0 = std::chrono::steady_clock::now();
+            for (int r = 0; r < repeticiones; ++r) {
+                for (Node* hub : hub_nodes) sink += evaluarConMapa(hub, comms, quality);
+            }
+            auto t1 = std::chrono::steady_clock::now();
+
+            NeighborAccumulator acc(n_comms + hubs);
+            for (int r = 0; r < repeticiones; ++r) {
+                for (Node* hub : hub_nodes) sink += evaluarConAcumulador(hub, comms, quality, acc);
+            }
+            auto t2 = std::chrono::steady_clock::now();
+
+            double procesados = static_cast<double>(hubs) * repeticiones;
+            double seg_mapa = std::chrono::duration<double>(t1 - t0).count();
+            double seg_acc = std::chrono::duration<double>(t2 - t1).count();
+            double nps_mapa = procesados / seg_mapa;
+            double nps_acc = procesados / seg_acc;
+
+            std::cout << std::left << std::setw(10) << grado << std::setw(14) << n_comms
+                      << std::setw(18) << std::fixed << std::setprecision(0) << nps_mapa
+                      << std::setw(22) << nps_acc
+                      << std::setprecision(2) << (nps_acc / nps_mapa) << "x" << std::endl;
+            if (sink < 0.0) std::cout << sink << std::endl; // evita que se elimine el cálculo
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,154 @@
+/**
+ * @file BenchGanancia.cpp
+ * @brief Micro-benchmark de la búsqueda de la mejor comunidad destino de un nodo.
+ * @details Compara el bucle anterior (ΔQ CPM calculado clave a clave sobre el acumulador, consultando el
+ * tamaño de cada comunidad) con la búsqueda sobre arrays contiguos de Algoritmo: reunir las candidatas y
+ * elegir la mejor con bestCandidate() en cada una de sus versiones (escalar, AVX2 y AVX-512, si la CPU las
+ * soporta). Para cada nº de comunidades candidatas genera varios nodos sintéticos y mide cuántos nodos por
+ * segundo procesa cada método (reunir las candidatas + buscar la mejor).
+ *
+ * Compilación: objetivo bench_ganancia del CMakeLists.txt, o a mano desde la raíz del repositorio:
+ *   g++ -std=c++17 -O2 -I. benchmarks/BenchGanancia.cpp NeighborAccumulator.cpp GainKernel.cpp -o bench_ganancia
+ */
+#include "NeighborAccumulator.h"
+#include "GainKernel.h"
+#include "QualityFunction.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace networkStructure;
+
+namespace {
+
+using NeighborFn = int (*)(const int*, std::size_t, int, const double*, const unsigned int*, const double*, double,
+                           double, double&);
+
+// Pesos de un nodo hacia sus comunidades vecinas (la comunidad actual es siempre la 0)
+struct NodoSintetico {
+    NeighborAccumulator weights;
+    double k_i_in_i = 0.0;
+};
+
+// Método anterior: ΔQ de cada comunidad vecina, una a una
+int evaluarBucle(const NodoSintetico& nodo, const std::vector<unsigned int>& sizes, const std::vector<double>& degrees,
+                 const CPMQuality& quality, double min_gain) {
+    int best_comm = -1;
+    double best_dQ = 0.0;
+    for (int comm_j : nodo.weights.getKeys()) {
+        if (comm_j == 0) continue;
+        double dQ = quality.gain(nodo.weights.get(comm_j), nodo.k_i_in_i, 1.0, 1.0, sizes[0], degrees[0],
+                                 sizes[comm_j], degrees[comm_j]);
+        if (dQ - best_dQ > min_gain) {
+            best_dQ = dQ;
+            best_comm = comm_j;
+        }
+    }
+    return best_comm;
+}
+
+// Método nuevo: una sola reducción vectorial sobre las claves del acumulador con la versión indicada
+int evaluarKernel(const NodoSintetico& nodo, const std::vector<unsigned int>& sizes, const std::vector<double>& degrees,
+                  const CPMQuality& quality, double min_gain, NeighborFn kernel) {
+    LinearGain gain = quality.linearGain(nodo.k_i_in_i, 1.0, 1.0, sizes[0], degrees[0]);
+    const std::vector<int>& keys = nodo.weights.getKeys();
+    double score = 0.0;
+    int best = kernel(keys.data(), keys.size(), 0, nodo.weights.getWeights(), sizes.data(), degrees.data(),
+                      gain.alpha, gain.beta, score);
+    return (best != -1 && score + gain.offset > min_gain) ? best : -1;
+}
+
+} // namespace
+
+int main() {
+    const int nodos = 256;
+    const int repeticiones = 200;
+    const double gamma = 0.001;
+    const double min_gain = 0.000001;
+    const std::vector<unsigned int> candidatas = {4, 16, 32, 64, 256, 1024, 4096};
+
+    struct Version {
+        const char* nombre;
+        NeighborFn kernel;
+        bool soportada;
+    };
+    const std::vector<Version> versiones = {
+        {"escalar", bestNeighborScalar, true},
+        {"avx2", bestNeighborAVX2, isSimdLevelSupported(SimdLevel::AVX2)},
+        {"avx512", bestNeighborAVX512, isSimdLevelSupported(SimdLevel::AVX512)},
+        {"despacho", bestNeighbor, true},
+    };
+    std::cout << "Version elegida en tiempo de ejecucion: " << simdLevelName(getSimdLevel()) << std::endl;
+
+    std::cout << std::left << std::setw(12) << "Candidatas" << std::setw(18) << "bucle (nodos/s)";
+    for (const Version& v : versiones) {
+        std::cout << std::setw(26) << (std::string(v.nombre) + " (nodos/s, acel.)");
+    }
+    std::cout << std::endl;
+
+    for (unsigned int n_cand : candidatas) {
+        std::mt19937 rng(12345u + n_cand);
+        std::uniform_real_distribution<double> weight_dist(0.5, 5.0);
+        std::uniform_int_distribution<unsigned int> size_dist(1, 500);
+
+        // Tamaño y grado total de cada comunidad (como CommunityState)
+        std::vector<unsigned int> sizes(n_cand + 1);
+        std::vector<double> degrees(n_cand + 1);
+        for (unsigned int c = 0; c <= n_cand; ++c) {
+            sizes[c] = size_dist(rng);
+            degrees[c] = 10.0 * sizes[c];
+        }
+        std::vector<NodoSintetico> datos(nodos);
+        for (NodoSintetico& nodo : datos) {
+            nodo.weights.resize(n_cand + 1);
+            nodo.k_i_in_i = weight_dist(rng);
+            nodo.weights.add(0, nodo.k_i_in_i);
+            for (unsigned int c = 1; c <= n_cand; ++c) nodo.weights.add(static_cast<int>(c), weight_dist(rng));
+        }
+        const CPMQuality quality(gamma, 0.0, 0.0);
+        double procesados = static_cast<double>(nodos) * repeticiones;
+
+        // Todas las versiones deben elegir el mismo destino que el bucle
+        std::vector<int> esperado;
+        for (const NodoSintetico& nodo : datos) esperado.push_back(evaluarBucle(nodo, sizes, degrees, quality, min_gain));
+
+        long long sink = 0;
+        int discrepancias = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        for (int r = 0; r < repeticiones; ++r) {
+            for (const NodoSintetico& nodo : datos) sink += evaluarBucle(nodo, sizes, degrees, quality, min_gain);
+        }
+        double nps_bucle = procesados / std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        std::cout << std::left << std::setw(12) << n_cand << std::setw(18) << std::fixed << std::setprecision(0)
+                  << nps_bucle;
+
+        for (const Version& v : versiones) {
+            if (!v.soportada) {
+                std::cout << std::setw(26) << "-";
+                continue;
+            }
+            for (std::size_t k = 0; k < datos.size(); ++k) {
+                if (evaluarKernel(datos[k], sizes, degrees, quality, min_gain, v.kernel) != esperado[k]) ++discrepancias;
+            }
+            auto t1 = std::chrono::steady_clock::now();
+            for (int r = 0; r < repeticiones; ++r) {
+                for (const NodoSintetico& nodo : datos) {
+                    sink += evaluarKernel(nodo, sizes, degrees, quality, min_gain, v.kernel);
+                }
+            }
+            double nps = procesados / std::chrono::duration<double>(std::chrono::steady_clock::now() - t1).count();
+            std::ostringstream celda;
+            celda << std::fixed << std::setprecision(0) << nps << " (" << std::setprecision(2) << nps / nps_bucle << "x)";
+            std::cout << std::setw(26) << celda.str();
+        }
+        if (discrepancias > 0) std::cout << discrepancias << " destinos distintos del bucle";
+        std::cout << std::endl;
+        if (sink < 0) std::cout << sink << std::endl; // evita que se elimine el cálculo
+    }
+    return 0;
+}
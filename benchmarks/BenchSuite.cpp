@@ -0,0 +1,276 @@
+/**
+ * @file BenchSuite.cpp
+ * @brief Benchmark de extremo a extremo sobre redes sintéticas con comunidades de referencia.
+ * @details Para cada generador (SBM, LFR, Erdős-Rényi y anillo de cliques), tamaño de red y nº de hilos
+ * genera la red con una semilla fija, la escribe como CSV y mide por separado:
+ *  - carga: lectura del CSV en paralelo, traducción de IDs e inserción en la Network;
+ *  - movimiento local: un Algoritmo::run() en modo BATCH desde la partición trivial;
+ *  - fusión: Algoritmo::mergeCommunities() sobre el resultado anterior;
+ *  - total: carga + Algoritmo::runMultilevel() completo, cuya partición se compara con la de referencia (NMI).
+ * Cada medida es la mediana de varias repeticiones. Los resultados se muestran como tabla y, opcionalmente,
+ * se guardan en CSV para comparar dos versiones del código con las mismas redes.
+ *
+ * Uso:
+ *   bench_suite [--generators sbm,lfr,er,ring] [--sizes 1000,10000] [--threads 1,2,4] [--reps 3]
+ *               [--quality cpm|modularity|rber] [--gamma 0.05] [--seed 1] [--csv resultados.csv]
+ *
+ * Compilación: objetivo bench_suite del CMakeLists.txt.
+ */
+#include "Algoritmo.h"
+#include "EdgeListParser.h"
+#include "GraphGenerator.h"
+#include "IdMap.h"
+#include "Network.h"
+#include "Partition.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <omp.h>
+
+using namespace networkStructure;
+
+namespace {
+
+// Silencia std::cout mientras existe (los algoritmos informan de sus tiempos por la salida estándar)
+class SilenciarSalida {
+public:
+    SilenciarSalida() : anterior(std::cout.rdbuf(nulo.rdbuf())) {}
+    ~SilenciarSalida() { std::cout.rdbuf(anterior); }
+
+private:
+    std::ostringstream nulo;
+    std::streambuf* anterior;
+};
+
+struct Configuracion {
+    std::vector<std::string> generadores = {"sbm", "lfr", "er", "ring"};
+    std::vector<unsigned int> tamanos = {1000, 10000, 100000};
+    std::vector<int> hilos;
+    int repeticiones = 3;
+    QualityType quality = QualityType::CPM;
+    double gamma = 0.05;
+    unsigned int seed = 1;
+    std::string csv;
+};
+
+struct Medida {
+    double carga = 0.0;
+    double local = 0.0;
+    double fusion = 0.0;
+    double total = 0.0;
+    double nmi = 0.0;
+    std::size_t comunidades = 0;
+};
+
+std::vector<std::string> dividir(const std::string& lista) {
+    std::vector<std::string> partes;
+    std::stringstream ss(lista);
+    std::string parte;
+    while (std::getline(ss, parte, ',')) {
+        if (!parte.empty()) partes.push_back(parte);
+    }
+    return partes;
+}
+
+// Red de prueba de unos n nodos con el generador indicado (grado medio en torno a 20)
+bool generar(const std::string& nombre, unsigned int n, unsigned int seed, GeneratedGraph& graph) {
+    if (nombre == "sbm") {
+        unsigned int bloque = std::min(100u, n);
+        unsigned int n_bloques = std::max(1u, n / bloque);
+        double p_out = n > bloque ? 4.0 / (n - bloque) : 0.0;
+        graph = generateSBM(n_bloques, bloque, 16.0 / (bloque - 1), p_out, seed);
+    } else if (nombre == "lfr") {
+        graph = generateLFR(n, 20.0, 50, 0.3, 20, 100, seed);
+    } else if (nombre == "er") {
+        graph = generateErdosRenyi(n, n > 1 ? 20.0 / (n - 1) : 0.0, seed);
+    } else if (nombre == "ring") {
+        graph = generateRingOfCliques(std::max(2u, n / 10), 10);
+    } else {
+        std::cerr << "Error: Generador desconocido " << nombre << " (sbm, lfr, er o ring)." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Igual que la carga del programa principal: CSV en paralelo, IDs densos e inserción en la red
+bool cargar(const std::string& filename, Network& network, IdMap& ids) {
+    std::vector<EdgeRecord> edges;
+    if (!parseEdgeListCSV(filename, edges)) return false;
+    ids.build(edges);
+    ids.translate(edges);
+    network.addEdges(edges);
+    return true;
+}
+
+double mediana(std::vector<double> valores) {
+    std::sort(valores.begin(), valores.end());
+    std::size_t k = valores.size() / 2;
+    return valores.size() % 2 ? valores[k] : 0.5 * (valores[k - 1] + valores[k]);
+}
+
+bool medir(const std::string& filename, const GeneratedGraph& graph, const Configuracion& config, Medida& medida) {
+    const double min_gain = 0.000001;
+    std::vector<double> cargas, locales, fusiones, totales;
+    for (int r = 0; r < config.repeticiones; ++r) {
+        // Carga, movimiento local y fusión de un nivel
+        Network network;
+        IdMap ids;
+        double t0 = omp_get_wtime();
+        if (!cargar(filename, network, ids)) return false;
+        double t1 = omp_get_wtime();
+        Partition partition(network);
+        Algoritmo algoritmo(&network, &partition);
+        double t2, t3, t4;
+        {
+            SilenciarSalida silencio;
+            t2 = omp_get_wtime();
+            algoritmo.run(min_gain, config.gamma, MoveMode::BATCH, true, config.quality);
+            t3 = omp_get_wtime();
+            algoritmo.mergeCommunities();
+            t4 = omp_get_wtime();
+        }
+        cargas.push_back(t1 - t0);
+        locales.push_back(t3 - t2);
+        fusiones.push_back(t4 - t3);
+
+        // De extremo a extremo: carga + multinivel completo
+        Network red;
+        IdMap red_ids;
+        std::vector<int> comunidades;
+        double t5 = omp_get_wtime();
+        if (!cargar(filename, red, red_ids)) return false;
+        {
+            SilenciarSalida silencio;
+            Algoritmo multinivel(&red);
+            comunidades = multinivel.runMultilevel(config.gamma, min_gain, MoveMode::BATCH, 0, false, config.quality);
+        }
+        totales.push_back(omp_get_wtime() - t5);
+
+        // La partición obtenida, en los IDs del generador (los nodos aislados no están en la red)
+        std::vector<int> encontrada(graph.ground_truth.size(), -1);
+        for (std::size_t id = 0; id < comunidades.size(); ++id) {
+            if (comunidades[id] < 0 || !red_ids.contains(static_cast<unsigned int>(id))) continue;
+            encontrada[red_ids.getExternal(static_cast<unsigned int>(id))] = comunidades[id];
+        }
+        std::vector<int> referencia = graph.ground_truth;
+        for (std::size_t i = 0; i < referencia.size(); ++i) {
+            if (encontrada[i] < 0) referencia[i] = -1;
+        }
+        medida.nmi = normalizedMutualInformation(referencia, encontrada);
+        std::vector<int> distintas;
+        for (int c : encontrada) {
+            if (c >= 0) distintas.push_back(c);
+        }
+        std::sort(distintas.begin(), distintas.end());
+        medida.comunidades = std::unique(distintas.begin(), distintas.end()) - distintas.begin();
+    }
+    medida.carga = mediana(cargas);
+    medida.local = mediana(locales);
+    medida.fusion = mediana(fusiones);
+    medida.total = mediana(totales);
+    return true;
+}
+
+bool leerArgumentos(int argc, char* argv[], Configuracion& config) {
+    for (int i = 1; i < argc; ++i) {
+        std::string opcion = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Error: Falta el valor de " << opcion << std::endl;
+            return false;
+        }
+        std::string valor = argv[++i];
+        if (opcion == "--generators") {
+            config.generadores = dividir(valor);
+        } else if (opcion == "--sizes") {
+            config.tamanos.clear();
+            for (const std::string& s : dividir(valor)) config.tamanos.push_back(static_cast<unsigned int>(std::atol(s.c_str())));
+        } else if (opcion == "--threads") {
+            config.hilos.clear();
+            for (const std::string& s : dividir(valor)) config.hilos.push_back(std::atoi(s.c_str()));
+        } else if (opcion == "--reps") {
+            config.repeticiones = std::max(1, std::atoi(valor.c_str()));
+        } else if (opcion == "--quality") {
+            if (!parseQualityType(valor, config.quality)) {
+                std::cerr << "Error: Funcion de calidad no valida (cpm, modularity o rber)." << std::endl;
+                return false;
+            }
+        } else if (opcion == "--gamma") {
+            config.gamma = std::atof(valor.c_str());
+        } else if (opcion == "--seed") {
+            config.seed = static_cast<unsigned int>(std::atol(valor.c_str()));
+        } else if (opcion == "--csv") {
+            config.csv = valor;
+        } else {
+            std::cerr << "Error: Opcion desconocida " << opcion << std::endl;
+            return false;
+        }
+    }
+    if (config.hilos.empty()) {
+        config.hilos.push_back(1);
+        if (omp_get_max_threads() > 1) config.hilos.push_back(omp_get_max_threads());
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Configuracion config;
+    if (!leerArgumentos(argc, argv, config)) {
+        std::cerr << "Uso: " << argv[0] << " [--generators sbm,lfr,er,ring] [--sizes 1000,10000] [--threads 1,2,4]"
+                  << " [--reps 3] [--quality cpm|modularity|rber] [--gamma 0.05] [--seed 1] [--csv fichero]" << std::endl;
+        return 1;
+    }
+    std::ofstream csv;
+    if (!config.csv.empty()) {
+        csv.open(config.csv, std::ios::trunc);
+        if (!csv.is_open()) {
+            std::cerr << "Error: No se pudo crear el archivo " << config.csv << std::endl;
+            return 1;
+        }
+        csv << "generator,nodes,edges,threads,load_s,local_move_s,merge_s,end_to_end_s,nmi,communities\n";
+    }
+
+    std::cout << "Funcion de calidad: " << qualityName(config.quality) << " (gamma = " << config.gamma
+              << "), semilla " << config.seed << ", mediana de " << config.repeticiones << " repeticiones" << std::endl;
+    std::cout << std::left << std::setw(10) << "Red" << std::setw(10) << "Nodos" << std::setw(10) << "Aristas"
+              << std::setw(7) << "Hilos" << std::setw(11) << "Carga (s)" << std::setw(11) << "Local (s)"
+              << std::setw(11) << "Fusion (s)" << std::setw(11) << "Total (s)" << std::setw(8) << "NMI"
+              << "Comunidades" << std::endl;
+
+    const std::string filename = "bench_suite_red.csv";
+    for (const std::string& nombre : config.generadores) {
+        for (unsigned int n : config.tamanos) {
+            GeneratedGraph graph;
+            if (!generar(nombre, n, config.seed, graph)) return 1;
+            if (!writeEdgeListCSV(filename, graph.edges)) return 1;
+            for (int p : config.hilos) {
+                omp_set_num_threads(p);
+                Medida medida;
+                if (!medir(filename, graph, config, medida)) {
+                    std::remove(filename.c_str());
+                    return 1;
+                }
+                std::cout << std::left << std::setw(10) << nombre << std::setw(10) << graph.ground_truth.size()
+                          << std::setw(10) << graph.edges.size() << std::setw(7) << p << std::fixed
+                          << std::setprecision(4) << std::setw(11) << medida.carga << std::setw(11) << medida.local
+                          << std::setw(11) << medida.fusion << std::setw(11) << medida.total << std::setprecision(3)
+                          << std::setw(8) << medida.nmi << medida.comunidades << std::defaultfloat << std::endl;
+                if (csv.is_open()) {
+                    csv << nombre << ',' << graph.ground_truth.size() << ',' << graph.edges.size() << ',' << p << ','
+                        << medida.carga << ',' << medida.local << ',' << medida.fusion << ',' << medida.total << ','
+                        << medida.nmi << ',' << medida.comunidades << '\n';
+                }
+            }
+        }
+    }
+    std::remove(filename.c_str());
+    return 0;
+}
@@ -1,69 +1,99 @@
 #include <iostream>
 #include <fstream>
-#include <sstream>
 #include <string>
 #include <vector>
 #include <limits>
+#include <iomanip>
+#include <stdexcept>
+#include <cstdlib>
 #include "Network.h" 
 #include "Node.h"
 #include "Edge.h"
 #include "Algoritmo.h"
+#include "CompactGraph.h"
+#include "EdgeListParser.h"
+#include "IdMap.h"
+#include "Partition.h"
+#include "Telemetry.h"
+#include "Dendrogram.h"
+#include <set>
+#include <map>
 #include <omp.h> 
 
 using namespace networkStructure;
 
 /**
  * @brief Carga una red desde un archivo CSV.
+ * @details El fichero se interpreta en paralelo con parseEdgeListCSV(), los IDs externos se traducen
+ * a índices densos con IdMap y después las aristas se insertan en la red en un único paso.
  * @param filename Nombre del archivo CSV.
  * @param network Referencia a un objeto Network donde se cargará la red.
+ * @param ids Traducción entre los IDs del fichero y los IDs densos de la red.
+ * @param telemetry Métricas de la carga (tiempo de lectura, de traducción y de inserción); opcional.
  * @return true si la carga fue exitosa, false en caso contrario.
  */
-bool loadNetworkFromCSV(const std::string& filename, Network& network) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Error: No se pudo abrir el archivo " << filename << std::endl;
-        return false;
-    }
-
-    std::string line;
-    std::getline(file, line);
-
-    while (std::getline(file, line)) {
-        std::stringstream ss(line);
-        std::string origin_str, destiny_str, weight_str;
-
-        if (std::getline(ss, origin_str, ',') &&
-            std::getline(ss, destiny_str, ',') &&
-            std::getline(ss, weight_str)) {
-            try {
-                unsigned int origin_id = std::stoul(origin_str);
-                unsigned int destiny_id = std::stoul(destiny_str);
-                double weight = std::stod(weight_str);
-                network.addEdge(origin_id, destiny_id, weight);
-            } catch (const std::exception& e) {
-                std::cerr << "Advertencia: Se omitió una línea por formato inválido: " << line << std::endl;
-            }
+bool loadNetworkFromCSV(const std::string& filename, Network& network, IdMap& ids, Telemetry* telemetry = nullptr) {
+    std::vector<EdgeRecord> edges;
+    {
+        ScopedTimer timer(telemetry, Phase::LOAD_PARSE);
+        if (!parseEdgeListCSV(filename, edges)) {
+            return false;
         }
     }
-    file.close();
+    {
+        ScopedTimer timer(telemetry, Phase::LOAD_IDS);
+        ids.build(edges);
+        ids.translate(edges);
+    }
+    ScopedTimer timer(telemetry, Phase::LOAD_INSERT);
+    network.addEdges(edges);
+    if (telemetry) telemetry->add(Counter::EDGES_LOADED, edges.size());
     return true;
 }
+/**
+ * @brief Devuelve el ID del fichero de un nodo original (o su ID interno si no tiene traducción).
+ */
+std::string originalName(const IdMap& ids, unsigned int id) {
+    if (ids.contains(id)) {
+        return std::to_string(ids.getExternal(id));
+    }
+    return std::to_string(id);
+}
+
+/**
+ * @brief Devuelve el nombre con el que se muestra un nodo: su ID del fichero o, si es un supernodo
+ * creado al fusionar, su ID interno precedido de "S".
+ */
+std::string nodeName(const IdMap& ids, Node* node, bool merged) {
+    if (merged) {
+        return "S" + std::to_string(node->getID());
+    }
+    return originalName(ids, node->getID());
+}
+
 /**
  * @brief Imprime todos los nodos y sus conexiones en la red.
  * @param network La red a imprimir.
+ * @param partition Comunidad de cada nodo.
+ * @param ids Traducción a los IDs del fichero.
+ * @param merges Agregaciones aplicadas a la red; los miembros de cada supernodo se obtienen de aquí.
  */
-void printNetwork(Network& network) {
+void printNetwork(Network& network, const Partition& partition, const IdMap& ids, const Dendrogram& merges) {
     std::cout << "\n--- Estado Actual de la Red ---" << std::endl;
     std::cout << "Nodos Totales: " << network.getNNodes() << " | Aristas Totales: " << network.getNEdges() << std::endl;
-    for (const auto& pair : network.getNodesMap()) {
-        Node* node = pair.second.get();
+    bool merged = merges.getNLevels() > 0;
+    std::vector<std::vector<unsigned int>> members_of;
+    if (merged) {
+        members_of = merges.getMembers(merges.getNLevels());
+    }
+    for (const auto& ptr : network.getNodes()) {
+        Node* node = ptr.get();
         if (!node) continue;
-        std::cout << "Nodo " << node->getID() << " (Comunidad: " << node->getCommunity() << ", Grado: " << node->getDegree() << ")" << std::endl;
-        const auto& members = node->getMembers();
-        if (!members.empty()) {
+        std::cout << "Nodo " << nodeName(ids, node, merged) << " (Comunidad: " << partition.getCommunity(node->getID()) << ", Grado: " << node->getDegree() << ")" << std::endl;
+        if (merged && node->getID() < members_of.size()) {
             std::cout << "  Miembros: ";
-            for (unsigned int mid : members) {
-                std::cout << mid << " ";
+            for (unsigned int mid : members_of[node->getID()]) {
+                std::cout << originalName(ids, mid) << " ";
             }
             std::cout << std::endl;
         } else {
@@ -76,31 +106,31 @@ void printNetwork(Network& network) {
         } else {
             for (const auto& edge : adjList) {
                 Node* opposite = edge->getOpposite(node);
-                std::cout << "    -> Nodo " << opposite->getID() << " (via Arista ID " << edge->getID() << ", Peso: " << edge->getWeight() << ")" << std::endl;
+                std::cout << "    -> Nodo " << nodeName(ids, opposite, merged) << " (via Arista ID " << edge->getID() << ", Peso: " << edge->getWeight() << ")" << std::endl;
             }
         }
     }
 }
 
-void printNetworkLite(Network& network) {
+void printNetworkLite(Network& network, const IdMap& ids, const Dendrogram& merges) {
     std::cout << "\n--- Resumen de la Red ---" << std::endl;
     std::cout << "Nodos Totales: " << network.getNNodes() << " | Aristas Totales: " << network.getNEdges() << std::endl;
-    for (const auto& pair : network.getNodesMap()) {
-        Node* node = pair.second.get();
+    bool merged = merges.getNLevels() > 0;
+    for (const auto& ptr : network.getNodes()) {
+        Node* node = ptr.get();
         if (!node) continue;
-        const auto& members = node->getMembers();
-        std::size_t numMembers = members.size();
-        std::cout << "Nodo " << node->getID() << ": " << numMembers << " miembros" << std::endl;
+        std::size_t numMembers = merged ? node->getSize() : 0;
+        std::cout << "Nodo " << nodeName(ids, node, merged) << ": " << numMembers << " miembros" << std::endl;
     }
 }
 
-void printCommunities(Network& network) {
+void printCommunities(Network& network, const Partition& partition) {
     std::map<int, unsigned int> communitySizes;
     // Contar cuántos nodos hay en cada comunidad
-    for (const auto& pair : network.getNodesMap()) {
-        Node* node = pair.second.get();
+    for (const auto& ptr : network.getNodes()) {
+        Node* node = ptr.get();
         if (!node) continue;
-        int commId = node->getCommunity();
+        int commId = partition.getCommunity(node->getID());
         communitySizes[commId]++;   // sumamos 1 nodo a esa comunidad
     }
     std::cout << "Estado de las comunidades:" << std::endl;
@@ -112,20 +142,312 @@ void printCommunities(Network& network) {
     std::cout << "Numero de comunidades: " << communitySizes.size() << std::endl;
 }
 
+/**
+ * @brief Imprime el informe de uso de memoria de la red.
+ * @param network La red a analizar.
+ */
+void printMemoryUsage(const Network& network) {
+    MemoryUsage usage = network.getMemoryUsage();
+    std::cout << "Memoria: " << usage.total_bytes / 1024 << " KiB (nodos " << usage.node_bytes / 1024
+              << " KiB, aristas " << usage.edge_bytes / 1024 << " KiB, adyacencia " << usage.adjacency_bytes / 1024
+              << " KiB, indices " << usage.index_bytes / 1024 << " KiB)" << std::endl;
+    std::cout << "  " << usage.bytes_per_node << " bytes/nodo | " << usage.bytes_per_edge << " bytes/arista" << std::endl;
+}
+
+/**
+ * @brief Convierte una red en CSV al formato binario de CompactGraph.
+ * @param csv_filename Nombre del archivo CSV de entrada.
+ * @param bin_filename Nombre del archivo binario de salida.
+ * @return true si la conversión fue exitosa, false en caso contrario.
+ */
+bool convertCSVToBinary(const std::string& csv_filename, const std::string& bin_filename) {
+    std::vector<EdgeRecord> edges;
+    if (!parseEdgeListCSV(csv_filename, edges)) {
+        return false;
+    }
+    CompactGraph graph(edges);
+    if (!graph.saveBinary(bin_filename)) {
+        return false;
+    }
+    std::cout << "Red convertida: " << graph.getNNodes() << " nodos y " << graph.getNArcs() / 2
+              << " aristas guardados en " << bin_filename << std::endl;
+    return true;
+}
+
+/**
+ * @brief Indica si un nombre de archivo corresponde al formato binario (.cdg).
+ */
+bool isBinaryGraphFile(const std::string& filename) {
+    const std::string ext = ".cdg";
+    return filename.size() >= ext.size() && filename.compare(filename.size() - ext.size(), ext.size(), ext) == 0;
+}
+
+/**
+ * @brief Valor de gamma de las opciones del menú para cada función de calidad (la modularidad y RB usan
+ * la resolución estándar 1).
+ */
+double menuGamma(QualityType quality) {
+    return quality == QualityType::CPM ? 0.001 : 1.0;
+}
+
+/**
+ * @brief Carga un grafo binario con mmap, ejecuta el algoritmo CSR sobre él e imprime el resultado.
+ * @param filename Nombre del archivo binario.
+ * @param quality Función de calidad a optimizar.
+ * @param validate Comprobar el CSR completo al cargar (ver CompactGraph::loadBinary()).
+ * @return 0 si la ejecución fue correcta, 1 en caso contrario.
+ */
+int runFromBinary(const std::string& filename, QualityType quality, bool validate) {
+    std::cout << "Cargando red binaria..." << std::endl;
+    double t0 = omp_get_wtime();
+    CompactGraph graph;
+    if (!graph.loadBinary(filename, validate)) {
+        return 1;
+    }
+    double t1 = omp_get_wtime();
+    std::cout << "Red cargada con " << graph.getNNodes() << " nodos y " << graph.getNArcs() / 2
+              << " aristas en " << (t1 - t0) << " segundos." << std::endl;
+
+    std::cout << "Ejecutando algoritmo de deteccion de comunidades (CSR)..." << std::endl;
+    std::vector<int> community = Algoritmo::runCompact(graph, 0.000001, menuGamma(quality), true, quality); // min_gain, gamma
+    std::set<int> distinct(community.begin(), community.end());
+    std::cout << "Numero de comunidades: " << distinct.size() << std::endl;
+    return 0;
+}
+
+/**
+ * @brief Carga una red (CSV o binaria) directamente como grafo CSR, sin construir la Network.
+ * @param filename Nombre del archivo (.csv o .cdg).
+ * @param graph Grafo donde se cargará la red.
+ * @param validate Comprobar el CSR completo si la red es binaria (ver CompactGraph::loadBinary()).
+ * @return true si la carga fue exitosa, false en caso contrario.
+ */
+bool loadCompactGraph(const std::string& filename, CompactGraph& graph, bool validate) {
+    if (isBinaryGraphFile(filename)) {
+        return graph.loadBinary(filename, validate);
+    }
+    std::vector<EdgeRecord> edges;
+    if (!parseEdgeListCSV(filename, edges)) {
+        return false;
+    }
+    graph = CompactGraph(edges);
+    return true;
+}
+
+/**
+ * @brief Ejecuta un barrido de resolución e imprime la tabla gamma -> comunidades, calidad y tiempo,
+ * seguida de las mesetas de estabilidad (rangos consecutivos de gamma con el mismo nº de comunidades).
+ * @param filename Red a cargar (una sola vez) en CSV o binario.
+ * @param gamma_list Valores de gamma separados por comas.
+ * @param bisect_depth Nº máximo de rondas de bisección.
+ * @param quality Función de calidad a optimizar.
+ * @param validate Comprobar el CSR completo si la red es binaria.
+ * @return 0 si la ejecución fue correcta, 1 en caso contrario.
+ */
+int runResolutionSweep(const std::string& filename, const std::string& gamma_list, int bisect_depth, QualityType quality,
+                       bool validate) {
+    std::vector<double> gammas;
+    std::size_t start = 0;
+    while (start <= gamma_list.size()) {
+        std::size_t comma = gamma_list.find(',', start);
+        if (comma == std::string::npos) comma = gamma_list.size();
+        std::string token = gamma_list.substr(start, comma - start);
+        try {
+            std::size_t used = 0;
+            gammas.push_back(std::stod(token, &used));
+            if (used != token.size()) throw std::invalid_argument(token);
+        } catch (const std::exception&) {
+            std::cerr << "Error: Valor de gamma no valido: '" << token << "'" << std::endl;
+            return 1;
+        }
+        start = comma + 1;
+    }
+
+    std::cout << "Cargando red..." << std::endl;
+    CompactGraph graph;
+    if (!loadCompactGraph(filename, graph, validate)) {
+        return 1;
+    }
+    std::cout << "Red cargada con " << graph.getNNodes() << " nodos y " << graph.getNArcs() / 2 << " aristas." << std::endl;
+
+    double t0 = omp_get_wtime();
+    std::vector<ResolutionResult> results = Algoritmo::sweepResolution(graph, gammas, 0.000001, bisect_depth, quality);
+    double t1 = omp_get_wtime();
+
+    std::cout << "\n" << std::left << std::setw(14) << "gamma" << std::setw(14) << "comunidades"
+              << std::setw(18) << "calidad" << "tiempo (s)" << std::endl;
+    for (const ResolutionResult& r : results) {
+        std::cout << std::setw(14) << r.gamma << std::setw(14) << r.n_communities << std::setw(18) << r.quality
+                  << r.seconds << std::endl;
+    }
+    std::cout << std::right;
+
+    std::cout << "\nMesetas de estabilidad:" << std::endl;
+    for (std::size_t k = 0; k < results.size();) {
+        std::size_t end = k;
+        while (end + 1 < results.size() && results[end + 1].n_communities == results[k].n_communities) ++end;
+        std::cout << "  gamma [" << results[k].gamma << ", " << results[end].gamma << "]: "
+                  << results[k].n_communities << " comunidades (" << (end - k + 1) << " valores)" << std::endl;
+        k = end + 1;
+    }
+    std::cout << "Tiempo total del barrido: " << (t1 - t0) << " segundos (" << results.size() << " valores de gamma)." << std::endl;
+    return 0;
+}
+
+/**
+ * @brief Ejecuta el agrupamiento por consenso (Algoritmo::runEnsemble()) e imprime el tiempo y la calidad
+ * de cada ejecución aleatoria, su dispersión y el resultado del consenso.
+ * @param filename Red a cargar en CSV o binario.
+ * @param gamma Parámetro de resolución del CPM.
+ * @param n_runs Nº de ejecuciones aleatorias.
+ * @param threshold Fracción mínima de coincidencias para conservar una arista en el grafo de consenso.
+ * @param time_budget Presupuesto de tiempo en segundos (0 = sin límite).
+ * @param quality Función de calidad a optimizar.
+ * @param validate Comprobar el CSR completo si la red es binaria.
+ * @return 0 si la ejecución fue correcta, 1 en caso contrario.
+ */
+int runEnsembleClustering(const std::string& filename, double gamma, int n_runs, double threshold, double time_budget,
+                          QualityType quality, bool validate) {
+    if (n_runs < 1 || threshold < 0.0 || threshold > 1.0 || time_budget < 0.0) {
+        std::cerr << "Error: Parametros del consenso no validos (ejecuciones >= 1, umbral en [0, 1], presupuesto >= 0)." << std::endl;
+        return 1;
+    }
+    std::cout << "Cargando red..." << std::endl;
+    CompactGraph graph;
+    if (!loadCompactGraph(filename, graph, validate)) {
+        return 1;
+    }
+    std::cout << "Red cargada con " << graph.getNNodes() << " nodos y " << graph.getNArcs() / 2 << " aristas." << std::endl;
+
+    EnsembleResult result = Algoritmo::runEnsemble(graph, gamma, n_runs, 0.000001, threshold, time_budget, 1, quality);
+
+    std::cout << "\n" << std::left << std::setw(12) << "ejecucion" << std::setw(14) << "comunidades"
+              << std::setw(18) << "calidad" << "tiempo (s)" << std::endl;
+    for (std::size_t k = 0; k < result.run_quality.size(); ++k) {
+        std::cout << std::setw(12) << k << std::setw(14) << result.run_communities[k] << std::setw(18)
+                  << result.run_quality[k] << result.run_seconds[k] << std::endl;
+    }
+    std::cout << std::right;
+    std::cout << "\nEjecuciones completadas: " << result.run_quality.size() << " de " << n_runs << std::endl;
+    std::cout << "Calidad: media " << result.quality_mean << " | desviacion " << result.quality_stddev
+              << " | min " << result.quality_min << " | max " << result.quality_max << std::endl;
+    std::cout << "Consenso: " << result.n_communities << " comunidades | calidad " << result.quality
+              << " | " << result.consensus_seconds << " segundos" << std::endl;
+    std::cout << "Tiempo total: " << result.seconds << " segundos." << std::endl;
+    return 0;
+}
+
 /**
  * @brief Muestra el menú de opciones al usuario.
  */
 void showMenu() {
     std::cout << "\n--- Menu de Opciones ---" << std::endl;
     std::cout << "1. Imprimir la Red Completa" << std::endl;
-    std::cout << "2. Algoritmo de comunidades" << std::endl;
-    std::cout << "3. Fusionar nodos por comunidades" << std::endl;
-    std::cout << "4. Finalizar Ejecucion" << std::endl;
+    std::cout << "2. Algoritmo de comunidades (SPLICE)" << std::endl;
+    std::cout << "3. Algoritmo de comunidades por lotes (BATCH)" << std::endl;
+    std::cout << "4. Algoritmo de comunidades sobre CSR (BATCH)" << std::endl;
+    std::cout << "5. Fusionar nodos por comunidades" << std::endl;
+    std::cout << "6. Algoritmo multinivel completo (BATCH + fusion hasta converger)" << std::endl;
+    std::cout << "7. Algoritmo multinivel con refinamiento de Leiden" << std::endl;
+    std::cout << "8. Algoritmo de comunidades asincrono (CSR, sin barreras)" << std::endl;
+    std::cout << "9. Finalizar Ejecucion" << std::endl;
     std::cout << "Seleccione una opcion: ";
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    // Uso: programa [red.csv | red.cdg]  |  programa --convert red.csv red.cdg
+    //      programa --sweep red.csv|red.cdg g1,g2,... [rondas de bisección]
+    //      programa --ensemble red.csv|red.cdg gamma ejecuciones [umbral] [presupuesto]
+    // En cualquier modo se puede añadir --quality cpm|modularity|rber (CPM por defecto).
+    // Con --telemetry informe.json|informe.csv el menú guarda las métricas de carga, run() y fusión.
+    // Con --checkpoint fichero [--checkpoint-interval segundos] [--resume] las opciones multinivel del menú
+    // guardan puntos de control y, con --resume, la primera continúa desde el último guardado.
+    // Con --validate las redes binarias se cargan comprobando el CSR completo (offsets y vecinos).
+    std::string filename = "Test4001_Rodrigo.csv";
+    QualityType quality = QualityType::CPM;
+    std::string telemetry_file;
+    std::string checkpoint_file;
+    double checkpoint_interval = 0.0;
+    bool resume = false;
+    bool validate = false;
+    std::vector<char*> args;
+    for (int i = 0; i < argc; ++i) {
+        if (std::string(argv[i]) == "--quality") {
+            if (i + 1 >= argc || !parseQualityType(argv[i + 1], quality)) {
+                std::cerr << "Error: Funcion de calidad no valida (cpm, modularity o rber)." << std::endl;
+                return 1;
+            }
+            ++i;
+            continue;
+        }
+        if (std::string(argv[i]) == "--telemetry") {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: Falta el fichero de --telemetry." << std::endl;
+                return 1;
+            }
+            telemetry_file = argv[++i];
+            continue;
+        }
+        if (std::string(argv[i]) == "--checkpoint" || std::string(argv[i]) == "--checkpoint-interval") {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: Falta el valor de " << argv[i] << "." << std::endl;
+                return 1;
+            }
+            if (std::string(argv[i]) == "--checkpoint") {
+                checkpoint_file = argv[i + 1];
+            } else {
+                checkpoint_interval = std::atof(argv[i + 1]);
+            }
+            ++i;
+            continue;
+        }
+        if (std::string(argv[i]) == "--resume") {
+            resume = true;
+            continue;
+        }
+        if (std::string(argv[i]) == "--validate") {
+            validate = true;
+            continue;
+        }
+        args.push_back(argv[i]);
+    }
+    argc = static_cast<int>(args.size());
+    argv = args.data();
+    if (argc >= 2 && std::string(argv[1]) == "--sweep") {
+        if (argc != 4 && argc != 5) {
+            std::cerr << "Uso: " << argv[0] << " --sweep <red.csv|red.cdg> <g1,g2,...> [rondas de biseccion]" << std::endl;
+            return 1;
+        }
+        int bisect_depth = (argc == 5) ? std::atoi(argv[4]) : 0;
+        return runResolutionSweep(argv[2], argv[3], bisect_depth, quality, validate);
+    }
+    if (argc >= 2 && std::string(argv[1]) == "--ensemble") {
+        if (argc < 5 || argc > 7) {
+            std::cerr << "Uso: " << argv[0] << " --ensemble <red.csv|red.cdg> <gamma> <ejecuciones> [umbral] [presupuesto (s)]" << std::endl;
+            return 1;
+        }
+        double threshold = (argc >= 6) ? std::atof(argv[5]) : 0.5;
+        double time_budget = (argc == 7) ? std::atof(argv[6]) : 0.0;
+        return runEnsembleClustering(argv[2], std::atof(argv[3]), std::atoi(argv[4]), threshold, time_budget, quality,
+                                     validate);
+    }
+    if (argc >= 2 && std::string(argv[1]) == "--convert") {
+        if (argc != 4) {
+            std::cerr << "Uso: " << argv[0] << " --convert <red.csv> <red.cdg>" << std::endl;
+            return 1;
+        }
+        return convertCSVToBinary(argv[2], argv[3]) ? 0 : 1;
+    }
+    if (argc >= 2) {
+        filename = argv[1];
+    }
+    if (resume && checkpoint_file.empty()) {
+        std::cerr << "Error: --resume necesita --checkpoint <fichero>." << std::endl;
+        return 1;
+    }
+
     Network myNetwork;
+    IdMap ids;
      // Configurar número de hilos para OpenMP
     int p;
     std::cout << "Introduce el numero de cores a utilizar: ";
@@ -133,12 +455,27 @@ int main() {
     omp_set_num_threads(p);
     putenv((char*)"OMP_PLACES=cores");
     putenv((char*)"OMP_PROC_BIND=close");
+    // Las redes binarias se usan directamente como grafo CSR, sin construir la Network
+    if (isBinaryGraphFile(filename)) {
+        return runFromBinary(filename, quality, validate);
+    }
+    // Métricas de ejecución, solo si se ha pedido el informe
+    Telemetry telemetry_data;
+    Telemetry* telemetry = telemetry_file.empty() ? nullptr : &telemetry_data;
+
     // Cargamos la red
     std::cout << "Cargando red..." << std::endl;
-    if (!loadNetworkFromCSV("Test4001_Rodrigo.csv", myNetwork)) {
+    if (!loadNetworkFromCSV(filename, myNetwork, ids, telemetry)) {
         return 1; // Termina si no se puede cargar el archivo.
     }
     std::cout << "Red cargada con " << myNetwork.getNNodes() << " nodos y " << myNetwork.getNEdges() << " aristas." << std::endl;
+    printMemoryUsage(myNetwork);
+    // Las comunidades se guardan aparte de la red; todas las opciones del menú comparten esta partición.
+    // Las fusiones (opción 5) se registran en el dendrograma, que relaciona los supernodos con los nodos leídos.
+    Partition partition(myNetwork);
+    Dendrogram merges;
+    double gamma = menuGamma(quality);
+    std::cout << "Funcion de calidad: " << qualityName(quality) << " (gamma = " << gamma << ")" << std::endl;
 
     int choice;
     while (true) {
@@ -152,24 +489,70 @@ int main() {
         }
 
         if (choice == 1) { // Mostrar red
-            printNetwork(myNetwork);
-        } else if (choice == 2) { // Ejecutar algoritmo de comunidades
+            printNetwork(myNetwork, partition, ids, merges);
+        } else if (choice == 2 || choice == 3) { // Ejecutar algoritmo de comunidades
+            MoveMode mode = (choice == 2) ? MoveMode::SPLICE : MoveMode::BATCH;
             std::cout << "Ejecutando algoritmo de deteccion de comunidades..." << std::endl;
-            Algoritmo algoritmo(&myNetwork);
-            algoritmo.run(0.000001, 0.001); // min_gain, gamma
+            Algoritmo algoritmo(&myNetwork, &partition);
+            algoritmo.setTelemetry(telemetry);
+            algoritmo.setVerbose(true);
+            algoritmo.setDendrogram(&merges);
+            algoritmo.run(0.000001, gamma, mode, true, quality); // min_gain, gamma, modo
+            std::cout << "Algoritmo completado. Comunidades asignadas." << std::endl;
+            printCommunities(myNetwork, partition);
+        } else if (choice == 4) { // Algoritmo de comunidades sobre la instantánea CSR
+            std::cout << "Ejecutando algoritmo de deteccion de comunidades (CSR)..." << std::endl;
+            Algoritmo algoritmo(&myNetwork, &partition);
+            algoritmo.setTelemetry(telemetry);
+            algoritmo.setVerbose(true);
+            algoritmo.setDendrogram(&merges);
+            algoritmo.runCompact(0.000001, gamma, quality); // min_gain, gamma
             std::cout << "Algoritmo completado. Comunidades asignadas." << std::endl;
-            printCommunities(myNetwork);
-        } else if (choice == 3) { // Fusionar nodos por comunidades
-            Algoritmo algoritmo(&myNetwork);
+            printCommunities(myNetwork, partition);
+        } else if (choice == 5) { // Fusionar nodos por comunidades
+            Algoritmo algoritmo(&myNetwork, &partition);
+            algoritmo.setTelemetry(telemetry);
+            algoritmo.setVerbose(true);
+            algoritmo.setDendrogram(&merges);
             algoritmo.mergeCommunities();
             std::cout << "Nodos fusionados por comunidades." << std::endl;
-            printNetworkLite(myNetwork);
-        } else if (choice == 4) { //Salir
+            printNetworkLite(myNetwork, ids, merges);
+        } else if (choice == 6 || choice == 7) { // Algoritmo multinivel (Louvain o Leiden)
+            bool refine = (choice == 7);
+            std::cout << "Ejecutando algoritmo multinivel..." << std::endl;
+            Algoritmo algoritmo(&myNetwork, &partition);
+            algoritmo.setTelemetry(telemetry);
+            algoritmo.setVerbose(true);
+            algoritmo.setDendrogram(&merges);
+            algoritmo.setCheckpoint(checkpoint_file, checkpoint_interval, resume);
+            resume = false; // Solo se reanuda la primera ejecución multinivel
+            std::vector<int> original_communities =
+                algoritmo.runMultilevel(gamma, 0.000001, MoveMode::BATCH, 0, refine, quality); // gamma, min_gain, modo, niveles, Leiden
+            std::size_t assigned = 0;
+            for (int comm : original_communities) {
+                if (comm >= 0) ++assigned;
+            }
+            std::cout << "Algoritmo completado. Nodos originales asignados: " << assigned << std::endl;
+            printCommunities(myNetwork, partition);
+        } else if (choice == 8) { // Movimiento local asíncrono
+            std::cout << "Ejecutando algoritmo de deteccion de comunidades (asincrono)..." << std::endl;
+            Algoritmo algoritmo(&myNetwork, &partition);
+            algoritmo.setTelemetry(telemetry);
+            algoritmo.setVerbose(true);
+            algoritmo.setDendrogram(&merges);
+            algoritmo.runAsync(0.000001, gamma, quality); // min_gain, gamma
+            std::cout << "Algoritmo completado. Comunidades asignadas." << std::endl;
+            printCommunities(myNetwork, partition);
+        } else if (choice == 9) { //Salir
             std::cout << "Finalizando ejecucion." << std::endl;
             break;
         } else {
             std::cout << "Opcion no válida. Inténtalo de nuevo." << std::endl;
         }
+        // El informe se reescribe tras cada opción con las métricas acumuladas
+        if (telemetry && choice >= 2 && choice <= 8) {
+            telemetry->writeReport(telemetry_file);
+        }
     }
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,207 @@
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Algoritmo.h"
+#include "CompactGraph.h"
+#include "DistributedCPM.h"
+#include "EdgeListParser.h"
+#include "GraphGenerator.h"
+#include "IdMap.h"
+#include "Network.h"
+#include <mpi.h>
+#include <omp.h>
+
+using namespace networkStructure;
+
+/**
+ * @brief Opciones de la línea de órdenes del programa distribuido.
+ */
+struct Opciones {
+    std::string filename;
+    double gamma = 0.001;
+    double min_gain = 0.000001;
+    std::uint64_t gather = 100000;
+    int max_sweeps = 100;
+    bool refine = false;
+    bool check = false;
+    unsigned int generate = 0; ///< Nº de nodos de la red LFR a generar en 'filename' antes de cargarla (0 = no).
+    std::string output;
+};
+
+/// Fracción de la calidad de un solo proceso que debe alcanzar la partición distribuida en --check.
+const double MIN_QUALITY_RATIO = 0.99;
+
+bool leerOpciones(int argc, char* argv[], Opciones& opciones) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--gamma" && has_value) {
+            opciones.gamma = std::atof(argv[++i]);
+        } else if (arg == "--gather" && has_value) {
+            opciones.gather = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--max-sweeps" && has_value) {
+            opciones.max_sweeps = std::atoi(argv[++i]);
+        } else if (arg == "--generate" && has_value) {
+            opciones.generate = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--output" && has_value) {
+            opciones.output = argv[++i];
+        } else if (arg == "--refine") {
+            opciones.refine = true;
+        } else if (arg == "--check") {
+            opciones.check = true;
+        } else if (!arg.empty() && arg[0] != '-' && opciones.filename.empty()) {
+            opciones.filename = arg;
+        } else {
+            return false;
+        }
+    }
+    return !opciones.filename.empty() && opciones.max_sweeps > 0;
+}
+
+/**
+ * @brief Compara la partición distribuida con la del algoritmo multinivel de un solo proceso.
+ * @details Reúne en el proceso 0 la comunidad de cada nodo, comprueba que todos los nodos de la red tienen
+ * exactamente una, que la calidad que devolvió DistributedCPM::run() coincide con la recalculada con
+ * Algoritmo::evaluateQuality() y que alcanza al menos MIN_QUALITY_RATIO veces la calidad de
+ * Algoritmo::runMultilevel() sobre la red completa; muestra también la NMI entre ambas particiones.
+ * @return 0 si las comprobaciones son correctas, 1 en caso contrario (el mismo valor en todos los procesos).
+ */
+int comprobarConSecuencial(const DistributedCPM& dist, const DistributedResult& result, const Opciones& opciones) {
+    // Pares (ID externo, comunidad) de todos los procesos
+    std::vector<std::uint64_t> pairs;
+    for (std::size_t k = 0; k < dist.getExternalIDs().size(); ++k) {
+        pairs.push_back(dist.getExternalIDs()[k]);
+        pairs.push_back(dist.getCommunities()[k]);
+    }
+    int count = static_cast<int>(pairs.size());
+    std::vector<int> counts(dist.getNRanks(), 0), displs(dist.getNRanks(), 0);
+    MPI_Gather(&count, 1, MPI_INT, counts.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+    for (int p = 1; p < dist.getNRanks(); ++p) displs[p] = displs[p - 1] + counts[p - 1];
+    std::vector<std::uint64_t> all_pairs(dist.getRank() == 0 ? displs.back() + counts.back() : 0);
+    MPI_Gatherv(pairs.data(), count, MPI_UINT64_T, all_pairs.data(), counts.data(), displs.data(), MPI_UINT64_T, 0,
+                MPI_COMM_WORLD);
+
+    int status = 0;
+    if (dist.getRank() == 0) {
+        std::vector<EdgeRecord> edges;
+        IdMap ids;
+        Network network;
+        parseEdgeListCSV(opciones.filename, edges);
+        ids.build(edges);
+        ids.translate(edges);
+        network.addEdges(edges);
+
+        // Partición distribuida sobre los índices densos de la carga secuencial
+        std::vector<int> distributed(ids.size(), -1);
+        std::unordered_map<std::uint64_t, int> renumber;
+        std::size_t assigned = 0;
+        for (std::size_t k = 0; k + 1 < all_pairs.size(); k += 2) {
+            unsigned int index = 0;
+            if (!ids.find(all_pairs[k], index) || distributed[index] != -1) {
+                status = 1;
+                continue;
+            }
+            auto it = renumber.emplace(all_pairs[k + 1], static_cast<int>(renumber.size())).first;
+            distributed[index] = it->second;
+            ++assigned;
+        }
+        if (assigned != ids.size()) status = 1;
+        if (status != 0) {
+            std::cerr << "Error: La particion distribuida no asigna una comunidad a cada nodo (" << assigned << " de "
+                      << ids.size() << ")." << std::endl;
+        } else {
+            CompactGraph graph(network);
+            double recomputed = Algoritmo::evaluateQuality(graph, distributed, opciones.gamma, QualityType::CPM);
+            double t0 = omp_get_wtime();
+            Algoritmo algoritmo(&network);
+            std::vector<int> sequential = algoritmo.runMultilevel(opciones.gamma, opciones.min_gain, MoveMode::BATCH, 0,
+                                                                  opciones.refine, QualityType::CPM);
+            double t1 = omp_get_wtime();
+            double sequential_quality = Algoritmo::evaluateQuality(graph, sequential, opciones.gamma, QualityType::CPM);
+            std::cout << "\n--- Comprobacion frente a un solo proceso ---" << std::endl;
+            std::cout << "Calidad distribuida: " << result.quality << " (recalculada " << recomputed << ")" << std::endl;
+            std::cout << "Calidad secuencial:  " << sequential_quality << " en " << (t1 - t0) << " segundos" << std::endl;
+            std::cout << "NMI entre ambas particiones: " << normalizedMutualInformation(distributed, sequential) << std::endl;
+            if (std::fabs(recomputed - result.quality) > 1e-6 * std::max(1.0, std::fabs(recomputed))) {
+                std::cerr << "Error: La calidad distribuida no coincide con la recalculada." << std::endl;
+                status = 1;
+            }
+            if (recomputed < sequential_quality - (1.0 - MIN_QUALITY_RATIO) * std::fabs(sequential_quality)) {
+                std::cerr << "Error: La calidad distribuida es menor que el " << MIN_QUALITY_RATIO * 100.0
+                          << "% de la secuencial." << std::endl;
+                status = 1;
+            }
+        }
+    }
+    MPI_Bcast(&status, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    return status;
+}
+
+int main(int argc, char* argv[]) {
+    // Solo el hilo principal de cada proceso llama a MPI; OpenMP se usa dentro de cada proceso
+    int provided = 0;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
+    int rank = 0, n_ranks = 1;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &n_ranks);
+
+    Opciones opciones;
+    if (!leerOpciones(argc, argv, opciones)) {
+        if (rank == 0) {
+            std::cerr << "Uso: mpirun -np N " << argv[0] << " <red.csv> [--gamma 0.001] [--gather nodos]"
+                      << " [--max-sweeps 100] [--refine] [--output comunidades.csv] [--check] [--generate nodos]" << std::endl;
+        }
+        MPI_Finalize();
+        return 1;
+    }
+
+    // Red de prueba: el proceso 0 escribe una red LFR de semilla fija que después leen todos
+    if (opciones.generate > 0) {
+        int generated = 1;
+        if (rank == 0) {
+            GeneratedGraph graph = generateLFR(opciones.generate, 15, 50, 0.3, 20, 100, 1);
+            generated = writeEdgeListCSV(opciones.filename, graph.edges) ? 1 : 0;
+        }
+        MPI_Bcast(&generated, 1, MPI_INT, 0, MPI_COMM_WORLD);
+        if (!generated) {
+            MPI_Finalize();
+            return 1;
+        }
+    }
+
+    DistributedCPM dist(MPI_COMM_WORLD);
+    double t0 = MPI_Wtime();
+    if (!dist.load(opciones.filename)) {
+        MPI_Finalize();
+        return 1;
+    }
+    double t1 = MPI_Wtime();
+    DistributedResult result = dist.run(opciones.gamma, opciones.min_gain, opciones.gather, opciones.max_sweeps,
+                                        opciones.refine);
+    if (rank == 0) {
+        std::cout << "Red cargada con " << result.n_nodes << " nodos en " << n_ranks << " procesos ("
+                  << omp_get_max_threads() << " hilos cada uno) en " << (t1 - t0) << " segundos." << std::endl;
+        std::cout << "Niveles distribuidos: " << result.distributed_levels << " | barridos: " << result.sweeps
+                  << " | movimientos: " << result.moves << std::endl;
+        if (result.gathered) {
+            std::cout << "Ultimos niveles en el proceso 0 con " << result.gathered_nodes << " nodos" << std::endl;
+        }
+        std::cout << "Numero de comunidades: " << result.n_communities << std::endl;
+        std::cout << "Calidad CPM: " << result.quality << std::endl;
+        std::cout << "Tiempo de la optimizacion: " << result.seconds << " segundos." << std::endl;
+    }
+
+    int status = 0;
+    if (!opciones.output.empty() && !dist.writeCommunities(opciones.output)) {
+        status = 1;
+    }
+    if (status == 0 && opciones.check) {
+        status = comprobarConSecuencial(dist, result, opciones);
+    }
+    MPI_Finalize();
+    return status;
+}